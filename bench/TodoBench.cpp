@@ -0,0 +1,782 @@
+#include <benchmark/benchmark.h>  // Google Benchmark
+#include <algorithm>                // For std::shuffle
+#include <atomic>                   // For the allocation counter
+#include <cstdlib>                  // For std::malloc / std::free and std::getenv
+#include <filesystem>               // For laying out the repository benchmark's lists
+#include <fstream>                  // For discarding the rendered task table
+#include <limits>                   // For an unlimited memory budget
+#include <map>                      // For caching prebuilt lists per size
+#include <memory>                   // For std::unique_ptr
+#include <new>                      // For replacing the global operator new/delete
+#include <random>                   // For the synthetic data generator
+#include <string>
+#include <vector>
+#include "CompressedText.h"
+#include "ConcurrentTodoList.h"
+#include "FileManager.h"
+#include "Task.h"
+#include "TaskFormatter.h"
+#include "TodoList.h"
+#include "TodoRepository.h"
+
+// ---------------------------------------------------------------------------
+// Allocation counting: every global new bumps a counter, so each benchmark can
+// report allocations per operation next to its timing.
+// ---------------------------------------------------------------------------
+
+static std::atomic<std::size_t> allocationCount{0};
+
+// GCC sees malloc/free through the replaced operators once they are inlined and misreports a mismatch
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+
+// Measures allocations made between construction and report()
+class AllocationScope {
+private:
+    std::size_t start;
+
+public:
+    AllocationScope() : start(allocationCount.load(std::memory_order_relaxed)) {}
+
+    // Publishes "allocs/op" and items/s, given how many operations the benchmark ran in total
+    void report(benchmark::State& state, std::size_t operations) const {
+        std::size_t allocations = allocationCount.load(std::memory_order_relaxed) - start;
+        state.SetItemsProcessed(static_cast<int64_t>(operations));
+        state.counters["allocs/op"] = operations == 0 ? 0.0 : static_cast<double>(allocations) / operations;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Synthetic data generator
+// ---------------------------------------------------------------------------
+
+// Builds realistic-looking descriptions: a few words, sometimes longer than the SSO buffer
+std::string makeDescription(std::mt19937_64& rng) {
+    static const char* const words[] = {
+        "buy", "milk", "call", "review", "pull", "request", "deploy", "service", "write",
+        "report", "fix", "login", "bug", "update", "docs", "plan", "sprint", "meeting"
+    };
+    std::string description;
+    int wordCount = 2 + static_cast<int>(rng() % 5);
+    for (int i = 0; i < wordCount; i++) {
+        if (i > 0) description += ' ';
+        description += words[rng() % (sizeof(words) / sizeof(words[0]))];
+    }
+    return description;
+}
+
+// Generates count tasks with sequential IDs, ~30% completed, creation dates a few seconds apart
+std::vector<Task> generateTasks(std::size_t count, std::uint64_t seed = 42) {
+    std::mt19937_64 rng(seed);
+    std::vector<Task> tasks;
+    tasks.reserve(count);
+
+    time_t created = 1700000000;
+    for (std::size_t i = 0; i < count; i++) {
+        created += static_cast<time_t>(rng() % 60);
+        bool completed = rng() % 10 < 3;
+        time_t completedAt = completed ? created + static_cast<time_t>(rng() % 86400) : 0;
+        tasks.emplace_back(static_cast<int>(i + 1), makeDescription(rng), completed, created, completedAt);
+    }
+    return tasks;
+}
+
+// Prebuilt lists are expensive at 10M tasks, so each size is generated once and shared
+const std::vector<Task>& cachedTasks(std::size_t count) {
+    static std::map<std::size_t, std::unique_ptr<std::vector<Task>>> cache;
+    auto& entry = cache[count];
+    if (!entry) {
+        entry = std::make_unique<std::vector<Task>>(generateTasks(count));
+    }
+    return *entry;
+}
+
+TodoList& cachedList(std::size_t count) {
+    static std::map<std::size_t, std::unique_ptr<TodoList>> cache;
+    auto& entry = cache[count];
+    if (!entry) {
+        entry = std::make_unique<TodoList>();
+        entry->setTasks(cachedTasks(count));
+    }
+    return *entry;
+}
+
+// Where the benchmarks keep their files: $TODO_BENCH_DIR if set, otherwise todo_bench under the system's
+// temporary directory (never the source tree)
+std::string benchPath(const std::string& name) {
+    static const std::filesystem::path directory = [] {
+        const char* configured = std::getenv("TODO_BENCH_DIR");
+        std::filesystem::path path = configured && *configured ? std::filesystem::path(configured)
+                                                            : std::filesystem::temp_directory_path() / "todo_bench";
+        std::filesystem::create_directories(path);
+        return path;
+    }();
+    return (directory / name).string();
+}
+
+// A task file on disk per size, written once
+std::string cachedFile(std::size_t count) {
+    std::string path = benchPath("bench_" + std::to_string(count) + ".txt");
+    static std::map<std::size_t, bool> written;
+    if (!written[count]) {
+        FileManager fileManager(path);
+        fileManager.setFsyncPolicy(FsyncPolicy::Never);
+        fileManager.saveTasks(cachedTasks(count));
+        written[count] = true;
+    }
+    return path;
+}
+
+// The same tasks as a compressed file (the ".zst" name makes FileManager compress them)
+std::string cachedCompressedFile(std::size_t count) {
+    std::string path = benchPath("bench_" + std::to_string(count) + ".txt.zst");
+    static std::map<std::size_t, bool> written;
+    if (!written[count]) {
+        FileManager fileManager(path);
+        fileManager.setFsyncPolicy(FsyncPolicy::Never);
+        fileManager.saveTasks(cachedTasks(count));
+        written[count] = true;
+    }
+    return path;
+}
+
+// The same tasks as a binary snapshot
+std::string cachedBinaryFile(std::size_t count) {
+    std::string path = benchPath("bench_" + std::to_string(count) + ".bin");
+    static std::map<std::size_t, bool> written;
+    if (!written[count]) {
+        FileManager fileManager(path);
+        fileManager.setFsyncPolicy(FsyncPolicy::Never);
+        fileManager.setSaveFormat(FileFormat::Binary);
+        fileManager.saveTasks(cachedTasks(count));
+        written[count] = true;
+    }
+    return path;
+}
+
+// 1K, 1M and 10M tasks
+void taskCounts(benchmark::internal::Benchmark* bench) {
+    bench->Arg(1000)->Arg(1000000)->Arg(10000000)->Unit(benchmark::kMillisecond);
+}
+
+// ---------------------------------------------------------------------------
+// Task serialization
+// ---------------------------------------------------------------------------
+
+void BM_TaskToString(benchmark::State& state) {
+    const std::vector<Task>& tasks = cachedTasks(1000);
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        for (const Task& task : tasks) {
+            benchmark::DoNotOptimize(task.toString());
+        }
+        operations += tasks.size();
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_TaskToString);
+
+void BM_TaskAppendTo(benchmark::State& state) {
+    const std::vector<Task>& tasks = cachedTasks(1000);
+    std::string buffer;
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        buffer.clear();
+        for (const Task& task : tasks) {
+            task.appendTo(buffer);
+        }
+        benchmark::DoNotOptimize(buffer.data());
+        operations += tasks.size();
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_TaskAppendTo);
+
+void BM_TaskFromString(benchmark::State& state) {
+    std::vector<std::string> lines;
+    for (const Task& task : cachedTasks(1000)) {
+        lines.push_back(task.toString());
+    }
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        for (const std::string& line : lines) {
+            benchmark::DoNotOptimize(Task::fromString(line));
+        }
+        operations += lines.size();
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_TaskFromString);
+
+void BM_TaskParse(benchmark::State& state) {
+    std::vector<std::string> lines;
+    for (const Task& task : cachedTasks(1000)) {
+        lines.push_back(task.toString());
+    }
+    Task task;
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        for (const std::string& line : lines) {
+            benchmark::DoNotOptimize(Task::parse(line, task));
+        }
+        operations += lines.size();
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_TaskParse);
+
+// ---------------------------------------------------------------------------
+// TodoList operations
+// ---------------------------------------------------------------------------
+
+void BM_AddTask(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        TodoList list;
+        for (std::size_t i = 0; i < count; i++) {
+            list.addTask("write the quarterly report");
+        }
+        operations += count;
+        state.PauseTiming(); // Tearing down the list isn't part of adding
+        list.clearAllTasks();
+        state.ResumeTiming();
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_AddTask)->Apply(taskCounts);
+
+void BM_AddTasks(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    std::vector<std::string> descriptions(count, "write the quarterly report");
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        TodoList list;
+        list.addTasks(descriptions);
+        operations += count;
+        state.PauseTiming();
+        list.clearAllTasks();
+        state.ResumeTiming();
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_AddTasks)->Apply(taskCounts);
+
+void BM_GetTaskById(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    TodoList& list = cachedList(count);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> pick(1, static_cast<int>(count));
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(list.getTaskById(pick(rng)));
+        operations++;
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_GetTaskById)->Arg(1000)->Arg(1000000)->Arg(10000000);
+
+void BM_RemoveTask(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    std::vector<int> order(count);
+    for (std::size_t i = 0; i < count; i++) order[i] = static_cast<int>(i + 1);
+    std::shuffle(order.begin(), order.end(), std::mt19937(3));
+
+    std::size_t operations = 0;
+    std::size_t allocationsDuringRemoves = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        TodoList list;
+        list.setTasks(cachedTasks(count));
+        std::size_t before = allocationCount.load(std::memory_order_relaxed);
+        state.ResumeTiming();
+
+        for (int id : order) {
+            list.removeTask(id);
+        }
+
+        state.PauseTiming();
+        allocationsDuringRemoves += allocationCount.load(std::memory_order_relaxed) - before;
+        operations += count;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(operations));
+    state.counters["allocs/op"] = static_cast<double>(allocationsDuringRemoves) / operations;
+}
+BENCHMARK(BM_RemoveTask)->Apply(taskCounts)->Iterations(1);
+
+// Same shuffled IDs as BM_RemoveTask, in one removeTasks call
+void BM_RemoveTasks(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    std::vector<int> order(count);
+    for (std::size_t i = 0; i < count; i++) order[i] = static_cast<int>(i + 1);
+    std::shuffle(order.begin(), order.end(), std::mt19937(3));
+
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        TodoList list;
+        list.setTasks(cachedTasks(count));
+        state.ResumeTiming();
+
+        list.removeTasks(order);
+        operations += count;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(operations));
+}
+BENCHMARK(BM_RemoveTasks)->Apply(taskCounts)->Iterations(1);
+
+// Drops every completed task in one pass
+void BM_RemoveIfCompleted(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        TodoList list;
+        list.setTasks(cachedTasks(count));
+        state.ResumeTiming();
+
+        operations += list.removeIf([](const Task& task) { return task.isCompleted(); });
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(operations));
+}
+BENCHMARK(BM_RemoveIfCompleted)->Apply(taskCounts)->Iterations(1);
+
+void BM_GetPendingTasks(benchmark::State& state) {
+    TodoList& list = cachedList(static_cast<std::size_t>(state.range(0)));
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        std::vector<Task> pending = list.getPendingTasks();
+        operations += pending.size();
+        benchmark::DoNotOptimize(pending.data());
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_GetPendingTasks)->Apply(taskCounts);
+
+void BM_ViewPendingTasks(benchmark::State& state) {
+    TodoList& list = cachedList(static_cast<std::size_t>(state.range(0)));
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        for (const Task& task : list.viewPendingTasks()) {
+            benchmark::DoNotOptimize(&task);
+            operations++;
+        }
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_ViewPendingTasks)->Apply(taskCounts);
+
+// Renders the menu's task table for every task; the stream discards it, so this is formatting alone
+void BM_RenderTable(benchmark::State& state) {
+    TodoList& list = cachedList(static_cast<std::size_t>(state.range(0)));
+    std::ofstream discard("/dev/null");
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        TaskTableWriter(discard).write(list.viewAllTasks());
+        operations += list.getTaskCount();
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_RenderTable)->Apply(taskCounts);
+
+// Runs one query per iteration; the index is built before timing starts
+void runSearch(benchmark::State& state, const TaskQuery& query) {
+    TodoList& list = cachedList(static_cast<std::size_t>(state.range(0)));
+    list.search(query);
+    std::size_t matches = 0;
+    for (auto _ : state) {
+        matches += list.search(query).size();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(matches));
+}
+
+void BM_SearchTerms(benchmark::State& state) {
+    runSearch(state, TaskQuery::parse("deploy service"));
+}
+BENCHMARK(BM_SearchTerms)->Apply(taskCounts);
+
+void BM_SearchPrefixPending(benchmark::State& state) {
+    runSearch(state, TaskQuery::parse("rep* status:pending"));
+}
+BENCHMARK(BM_SearchPrefixPending)->Apply(taskCounts);
+
+// Every task also gets one of 50K distinct "aNNNNN" words, so the prefix covers that many posting lists
+void BM_SearchPrefixManyWords(benchmark::State& state) {
+    static std::map<std::size_t, std::unique_ptr<TodoList>> cache;
+    auto count = static_cast<std::size_t>(state.range(0));
+    auto& list = cache[count];
+    if (!list) {
+        std::vector<Task> tasks;
+        tasks.reserve(count);
+        for (const Task& task : cachedTasks(count)) {
+            std::string description(task.getDescriptionView());
+            description += " a" + std::to_string(tasks.size() % 50000);
+            tasks.emplace_back(task.getId(), description, task.isCompleted(), task.getCreationDate(),
+                               task.getCompletionDate());
+        }
+        list = std::make_unique<TodoList>();
+        list->setTasks(tasks);
+    }
+
+    TaskQuery query = TaskQuery::parse("a*");
+    list->search(query);
+    std::size_t matches = 0;
+    for (auto _ : state) {
+        matches += list->search(query).size();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(matches));
+}
+BENCHMARK(BM_SearchPrefixManyWords)->Apply(taskCounts);
+
+void BM_SearchSubstring(benchmark::State& state) {
+    runSearch(state, TaskQuery::parse("\"bug upd\""));
+}
+BENCHMARK(BM_SearchSubstring)->Apply(taskCounts);
+
+// A one-hour window in the middle of the generated creation dates (tasks are ~30 s apart)
+void BM_CreatedBetween(benchmark::State& state) {
+    TodoList& list = cachedList(static_cast<std::size_t>(state.range(0)));
+    const std::vector<Task>& tasks = cachedTasks(static_cast<std::size_t>(state.range(0)));
+    time_t from = tasks[tasks.size() / 2].getCreationDate();
+    list.createdBetween(from, from);
+    std::size_t matches = 0;
+    for (auto _ : state) {
+        matches += list.createdBetween(from, from + 3600).size();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(matches));
+}
+BENCHMARK(BM_CreatedBetween)->Apply(taskCounts);
+
+void BM_OldestPending(benchmark::State& state) {
+    TodoList& list = cachedList(static_cast<std::size_t>(state.range(0)));
+    list.oldestPending(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(list.oldestPending(100).size());
+    }
+}
+BENCHMARK(BM_OldestPending)->Apply(taskCounts);
+
+void BM_CompletedPerDay(benchmark::State& state) {
+    TodoList& list = cachedList(static_cast<std::size_t>(state.range(0)));
+    const std::vector<Task>& tasks = cachedTasks(static_cast<std::size_t>(state.range(0)));
+    time_t from = tasks.front().getCreationDate();
+    time_t to = tasks.back().getCreationDate();
+    list.completedPerDay(from, from);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(list.completedPerDay(from, to).size());
+    }
+}
+BENCHMARK(BM_CompletedPerDay)->Apply(taskCounts);
+
+// ---------------------------------------------------------------------------
+// ConcurrentTodoList (run with 1..N threads to check that reads scale and don't stall writers)
+// ---------------------------------------------------------------------------
+
+ConcurrentTodoList& cachedConcurrentList(std::size_t count) {
+    static std::map<std::size_t, std::unique_ptr<ConcurrentTodoList>> cache;
+    auto& entry = cache[count];
+    if (!entry) {
+        entry = std::make_unique<ConcurrentTodoList>();
+        entry->setTasks(cachedTasks(count));
+    }
+    return *entry;
+}
+
+// Every lookup takes its own snapshot, so pinning and unpinning are part of the measured cost
+void BM_ConcurrentLookup(benchmark::State& state) {
+    static ConcurrentTodoList& list = cachedConcurrentList(1000000);
+    std::mt19937 rng(static_cast<unsigned>(state.thread_index()));
+    std::uniform_int_distribution<int> pick(1, 1000000);
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        ConcurrentTodoList::Snapshot snapshot = list.snapshot();
+        benchmark::DoNotOptimize(snapshot.find(pick(rng)));
+        operations++;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(operations));
+}
+BENCHMARK(BM_ConcurrentLookup)->ThreadRange(1, 8)->UseRealTime();
+
+// Thread 0 keeps adding and completing tasks while the others take snapshots and count pending tasks
+void BM_ConcurrentMixed(benchmark::State& state) {
+    static ConcurrentTodoList& list = cachedConcurrentList(1000);
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        if (state.thread_index() == 0) {
+            int id = list.addTask("write the quarterly report");
+            list.markTaskAsCompleted(id);
+            list.removeTask(id);
+        } else {
+            std::size_t pending = 0;
+            list.snapshot().forEach([&pending](const Task&) { pending++; }, TaskView::Filter::Pending);
+            benchmark::DoNotOptimize(pending);
+        }
+        operations++;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(operations));
+}
+BENCHMARK(BM_ConcurrentMixed)->ThreadRange(2, 8)->UseRealTime();
+
+// ---------------------------------------------------------------------------
+// FileManager
+// ---------------------------------------------------------------------------
+
+void BM_SaveTasks(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    const std::vector<Task>& tasks = cachedTasks(count);
+    FileManager fileManager(benchPath("bench_save.txt"));
+    fileManager.setFsyncPolicy(FsyncPolicy::Never); // Measure formatting and write(), not the disk
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        if (!fileManager.saveTasks(tasks)) {
+            state.SkipWithError("saveTasks failed");
+            break;
+        }
+        operations += count;
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_SaveTasks)->Apply(taskCounts);
+
+// Appends 100 tasks to an already saved list and saves it again: only the new lines are written
+void BM_SaveTasksIncremental(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    TodoList list;
+    list.setTasks(cachedTasks(count));
+    FileManager fileManager(benchPath("bench_save_incremental.txt"));
+    fileManager.setFsyncPolicy(FsyncPolicy::Never);
+    fileManager.setIncrementalSaves(true);
+    fileManager.saveTasks(list);
+    std::vector<std::string> batch(100, "write the quarterly report");
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        list.addTasks(batch);
+        state.ResumeTiming();
+        if (!fileManager.saveTasks(list)) {
+            state.SkipWithError("saveTasks failed");
+            break;
+        }
+        operations += batch.size();
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_SaveTasksIncremental)->Apply(taskCounts);
+
+// Same as BM_SaveTasks, as a binary snapshot; "bytes/task" is the snapshot's size per task
+void BM_SaveTasksBinary(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    const std::vector<Task>& tasks = cachedTasks(count);
+    FileManager fileManager(benchPath("bench_save.bin"));
+    fileManager.setFsyncPolicy(FsyncPolicy::Never);
+    fileManager.setSaveFormat(FileFormat::Binary);
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        if (!fileManager.saveTasks(tasks)) {
+            state.SkipWithError("saveTasks failed");
+            break;
+        }
+        operations += count;
+    }
+    allocations.report(state, operations);
+    std::uintmax_t bytes = std::filesystem::file_size(benchPath("bench_save.bin"));
+    state.counters["bytes/task"] = static_cast<double>(bytes) / static_cast<double>(count);
+}
+BENCHMARK(BM_SaveTasksBinary)->Apply(taskCounts);
+
+// Same as BM_SaveTasks, compressed; "ratio" is the text file's size over the compressed one's
+void BM_SaveTasksCompressed(benchmark::State& state) {
+    if (!CompressedText::available()) {
+        state.SkipWithError("built without zstd");
+        return;
+    }
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    const std::vector<Task>& tasks = cachedTasks(count);
+    FileManager fileManager(benchPath("bench_save.txt.zst"));
+    fileManager.setFsyncPolicy(FsyncPolicy::Never);
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        if (!fileManager.saveTasks(tasks)) {
+            state.SkipWithError("saveTasks failed");
+            break;
+        }
+        operations += count;
+    }
+    allocations.report(state, operations);
+    std::uintmax_t compressedBytes = std::filesystem::file_size(benchPath("bench_save.txt.zst"));
+    state.counters["ratio"] = static_cast<double>(std::filesystem::file_size(cachedFile(count))) /
+                              static_cast<double>(compressedBytes);
+}
+BENCHMARK(BM_SaveTasksCompressed)->Apply(taskCounts);
+
+void BM_LoadTasks(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    FileManager fileManager(cachedFile(count));
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        std::vector<Task> tasks = fileManager.loadTasks();
+        operations += tasks.size();
+        benchmark::DoNotOptimize(tasks.data());
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_LoadTasks)->Apply(taskCounts);
+
+void BM_LoadTasksParallel(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    FileManager fileManager(cachedFile(count));
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        std::vector<Task> tasks = fileManager.loadTasksParallel();
+        operations += tasks.size();
+        benchmark::DoNotOptimize(tasks.data());
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_LoadTasksParallel)->Apply(taskCounts);
+
+// Aggregates over the file without loading it: counts the pending tasks of the newer half
+void BM_StreamPendingCount(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    FileManager fileManager(cachedFile(count));
+    TaskFilter filter;
+    filter.status = TaskFilter::Status::Pending;
+    filter.createdFrom = cachedTasks(count)[count / 2].getCreationDate();
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        std::size_t pending = 0;
+        fileManager.forEachTask(filter, [&pending](const TaskRecord&) { pending++; });
+        benchmark::DoNotOptimize(pending);
+        operations += count;
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_StreamPendingCount)->Apply(taskCounts);
+
+// Loads straight into a TodoList's arena; allocs/op should be far below one
+void BM_LoadInto(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    FileManager fileManager(cachedFile(count));
+    TodoList list;
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        fileManager.loadInto(list);
+        operations += static_cast<std::size_t>(list.getTaskCount());
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_LoadInto)->Apply(taskCounts);
+
+// BM_LoadInto from a binary snapshot: the varint columns are decoded, then copied into the arena
+void BM_LoadIntoBinary(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    FileManager fileManager(cachedBinaryFile(count));
+    TodoList list;
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        fileManager.loadInto(list);
+        operations += static_cast<std::size_t>(list.getTaskCount());
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_LoadIntoBinary)->Apply(taskCounts);
+
+// BM_LoadInto from the compressed file: frames are decompressed in parallel, then parsed as usual
+void BM_LoadIntoCompressed(benchmark::State& state) {
+    if (!CompressedText::available()) {
+        state.SkipWithError("built without zstd");
+        return;
+    }
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    FileManager fileManager(cachedCompressedFile(count));
+    TodoList list;
+    AllocationScope allocations;
+    std::size_t operations = 0;
+    for (auto _ : state) {
+        fileManager.loadInto(list);
+        operations += static_cast<std::size_t>(list.getTaskCount());
+    }
+    allocations.report(state, operations);
+}
+BENCHMARK(BM_LoadIntoCompressed)->Apply(taskCounts);
+
+void BM_ClearAllTasks(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    TodoList list;
+    for (auto _ : state) {
+        state.PauseTiming();
+        list.setTasks(cachedTasks(count));
+        state.ResumeTiming();
+        list.clearAllTasks();
+    }
+}
+BENCHMARK(BM_ClearAllTasks)->Apply(taskCounts);
+
+// 1000 lists of 1000 tasks each, read in random order with room for state.range(0) of them in memory:
+// with a small budget most accesses are a first access (load) plus an eviction
+void BM_RepositoryRandomAccess(benchmark::State& state) {
+    const std::size_t listCount = 1000;
+    const std::string root = benchPath("bench_repository");
+    std::filesystem::create_directories(root);
+    for (std::size_t i = 0; i < listCount; i++) {
+        std::string path = root + "/team" + std::to_string(i) + ".txt";
+        if (!std::filesystem::exists(path)) {
+            std::filesystem::copy_file(cachedFile(1000), path);
+        }
+    }
+
+    std::size_t listBytes = 0;
+    {
+        TodoRepository probe(root, std::numeric_limits<std::size_t>::max(), std::chrono::milliseconds(0));
+        listBytes = probe.with("team0", [](TodoList& list) { return list.memoryUsage(); });
+    }
+    TodoRepository repository(root, listBytes * static_cast<std::size_t>(state.range(0)), std::chrono::milliseconds(0));
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::size_t> pick(0, listCount - 1);
+    for (auto _ : state) {
+        std::string name = "team" + std::to_string(pick(rng));
+        int pending = repository.with(name, [](TodoList& list) { return list.getPendingCount(); });
+        benchmark::DoNotOptimize(pending);
+    }
+    state.counters["loaded"] = static_cast<double>(repository.loadedCount());
+}
+BENCHMARK(BM_RepositoryRandomAccess)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,341 @@
+// Load generator for the --serve mode: opens many client connections, keeps a fixed number of commands in
+// flight on each, and reports throughput and latency percentiles.
+//
+//   todo_loadgen (--unix <path> | --tcp <port>) [--clients N] [--pipeline D] [--threads T] [--seconds S] [--ids K]
+//
+// Each client sends a mix of get (60%), add (25%), done (10%) and count (5%) commands, with task IDs drawn
+// from 1..K. A command's latency runs from when it was handed to send() to when its OK/ERR line arrives.
+#include <algorithm>        // For std::nth_element
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>           // For std::printf
+#include <cstdlib>          // For std::atoi
+#include <cstring>          // For std::memchr, std::memcpy and std::strerror
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string unixPath;
+    int tcpPort = 0;
+    int clients = 100;
+    int pipeline = 1;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency() / 2));
+    double seconds = 5.0;
+    int ids = 100000;
+};
+
+struct Client {
+    int fd = -1;
+    std::string input;                    // Reply bytes not yet split into lines
+    std::string output;                   // Commands not yet sent
+    std::size_t outputSent = 0;
+    std::deque<Clock::time_point> sentAt; // One per command in flight, oldest first
+    bool watchingWrites = false;
+};
+
+// What one worker thread measured
+struct WorkerResult {
+    std::vector<std::uint32_t> latencies;  // Nanoseconds (saturating), one per completed command
+    std::size_t errors = 0;
+    bool failed = false;
+};
+
+std::atomic<bool> stopSending{false};
+
+int connectClient(const Options& options) {
+    int fd;
+    if (!options.unixPath.empty()) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, options.unixPath.c_str(),
+                    std::min(options.unixPath.size() + 1, sizeof(address.sun_path) - 1));
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            close(fd);
+            fd = -1;
+        }
+    } else {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<std::uint16_t>(options.tcpPort));
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            close(fd);
+            fd = -1;
+        }
+        if (fd >= 0) {
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+    }
+    if (fd >= 0) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+    return fd;
+}
+
+class Worker {
+private:
+    const Options& options;
+    std::vector<Client> clients;
+    int epollFd;
+    std::mt19937 rng;
+    WorkerResult result;
+
+    void queueCommand(Client& client) {
+        int roll = static_cast<int>(rng() % 100);
+        int id = static_cast<int>(rng() % static_cast<unsigned>(options.ids)) + 1;
+        if (roll < 60) {
+            client.output += "get " + std::to_string(id) + "\n";
+        } else if (roll < 85) {
+            client.output += "add load generator task " + std::to_string(id) + "\n";
+        } else if (roll < 95) {
+            client.output += "done " + std::to_string(id) + "\n";
+        } else {
+            client.output += "count\n";
+        }
+        client.sentAt.push_back(Clock::now());
+    }
+
+    // Sends what the socket takes; false if the connection broke
+    bool flush(std::size_t index) {
+        Client& client = clients[index];
+        while (client.outputSent < client.output.size()) {
+            ssize_t bytes = send(client.fd, client.output.data() + client.outputSent,
+                                 client.output.size() - client.outputSent, MSG_NOSIGNAL);
+            if (bytes < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+                break;
+            }
+            client.outputSent += static_cast<std::size_t>(bytes);
+        }
+        if (client.outputSent == client.output.size()) {
+            client.output.clear();
+            client.outputSent = 0;
+        }
+
+        bool wantWrites = !client.output.empty();
+        if (wantWrites != client.watchingWrites) {
+            epoll_event event{};
+            event.events = EPOLLIN | (wantWrites ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+            event.data.u64 = index;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, client.fd, &event);
+            client.watchingWrites = wantWrites;
+        }
+        return true;
+    }
+
+    // Reads replies, records a latency per status line and refills the pipeline; false if the connection broke
+    bool receive(std::size_t index) {
+        Client& client = clients[index];
+        char buffer[64 * 1024];
+        ssize_t bytes = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (bytes <= 0) {
+            return bytes < 0 && (errno == EAGAIN || errno == EINTR);
+        }
+        client.input.append(buffer, static_cast<std::size_t>(bytes));
+
+        Clock::time_point now = Clock::now();
+        std::size_t consumed = 0;
+        while (const void* newline = std::memchr(client.input.data() + consumed, '\n', client.input.size() - consumed)) {
+            const char* line = client.input.data() + consumed;
+            std::size_t length = static_cast<const char*>(newline) - line;
+            consumed += length + 1;
+
+            bool ok = length == 2 && line[0] == 'O' && line[1] == 'K';
+            bool error = length >= 3 && std::memcmp(line, "ERR", 3) == 0;
+            if (!ok && !error) {
+                continue;  // A task line printed by get
+            }
+            if (client.sentAt.empty()) {
+                std::cerr << "Error: Reply without a command" << std::endl;
+                return false;
+            }
+            auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(now - client.sentAt.front()).count();
+            client.sentAt.pop_front();
+            result.latencies.push_back(static_cast<std::uint32_t>(std::min<long long>(nanoseconds, UINT32_MAX)));
+            result.errors += error ? 1 : 0;
+            if (!stopSending.load(std::memory_order_relaxed)) {
+                queueCommand(client);
+            }
+        }
+        client.input.erase(0, consumed);
+        return flush(index);
+    }
+
+public:
+    Worker(const Options& options, unsigned seed) : options(options), epollFd(epoll_create1(EPOLL_CLOEXEC)), rng(seed) {}
+
+    ~Worker() {
+        for (Client& client : clients) {
+            if (client.fd >= 0) close(client.fd);
+        }
+        close(epollFd);
+    }
+
+    bool connectClients(int count) {
+        clients.resize(static_cast<std::size_t>(count));
+        for (std::size_t i = 0; i < clients.size(); i++) {
+            clients[i].fd = connectClient(options);
+            if (clients[i].fd < 0) {
+                std::cerr << "Error: Could not connect client " << i << ": " << std::strerror(errno) << std::endl;
+                return false;
+            }
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.u64 = i;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, clients[i].fd, &event);
+        }
+        return true;
+    }
+
+    // Runs until stopSending is set and every command in flight has been answered (or 5 s passed after that)
+    WorkerResult run() {
+        for (std::size_t i = 0; i < clients.size(); i++) {
+            for (int depth = 0; depth < options.pipeline; depth++) {
+                queueCommand(clients[i]);
+            }
+            if (!flush(i)) {
+                result.failed = true;
+                return std::move(result);
+            }
+        }
+
+        Clock::time_point drainDeadline = Clock::time_point::max();
+        epoll_event events[256];
+        while (true) {
+            std::size_t inFlight = 0;
+            for (const Client& client : clients) inFlight += client.sentAt.size();
+            if (stopSending.load(std::memory_order_relaxed)) {
+                if (inFlight == 0) break;
+                if (drainDeadline == Clock::time_point::max()) drainDeadline = Clock::now() + std::chrono::seconds(5);
+                if (Clock::now() > drainDeadline) {
+                    std::cerr << "Error: " << inFlight << " command(s) never answered" << std::endl;
+                    result.failed = true;
+                    break;
+                }
+            }
+
+            int ready = epoll_wait(epollFd, events, 256, 50);
+            for (int i = 0; i < ready; i++) {
+                std::size_t index = events[i].data.u64;
+                bool alive = true;
+                if (events[i].events & EPOLLOUT) alive = flush(index);
+                if (alive && events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) alive = receive(index);
+                if (!alive) {
+                    std::cerr << "Error: Server closed a connection" << std::endl;
+                    result.failed = true;
+                    return std::move(result);
+                }
+            }
+        }
+        return std::move(result);
+    }
+};
+
+double percentile(std::vector<std::uint32_t>& values, double fraction) {
+    if (values.empty()) return 0.0;
+    std::size_t rank = std::min(values.size() - 1, static_cast<std::size_t>(fraction * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(rank), values.end());
+    return values[rank] / 1000.0;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+        if (arg == "--unix") options.unixPath = value;
+        else if (arg == "--tcp") options.tcpPort = std::atoi(value);
+        else if (arg == "--clients") options.clients = std::atoi(value);
+        else if (arg == "--pipeline") options.pipeline = std::atoi(value);
+        else if (arg == "--threads") options.threads = std::atoi(value);
+        else if (arg == "--seconds") options.seconds = std::atof(value);
+        else if (arg == "--ids") options.ids = std::atoi(value);
+        else return false;
+    }
+    return (!options.unixPath.empty() || options.tcpPort > 0) && options.clients > 0 && options.pipeline > 0 &&
+           options.threads > 0 && options.seconds > 0 && options.ids > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " (--unix <path> | --tcp <port>) [--clients N] [--pipeline D]"
+                  << " [--threads T] [--seconds S] [--ids K]\n";
+        return 1;
+    }
+    options.threads = std::min(options.threads, options.clients);
+
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    // Connect everyone before the clock starts
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int t = 0; t < options.threads; t++) {
+        workers.push_back(std::make_unique<Worker>(options, 1234u + static_cast<unsigned>(t)));
+        int share = options.clients / options.threads + (t < options.clients % options.threads ? 1 : 0);
+        if (!workers.back()->connectClients(share)) {
+            return 1;
+        }
+    }
+
+    std::vector<WorkerResult> results(workers.size());
+    std::vector<std::thread> threads;
+    Clock::time_point start = Clock::now();
+    for (std::size_t t = 0; t < workers.size(); t++) {
+        threads.emplace_back([&, t] { results[t] = workers[t]->run(); });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    stopSending.store(true);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<std::uint32_t> latencies;
+    std::size_t errors = 0;
+    bool failed = false;
+    for (WorkerResult& result : results) {
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        errors += result.errors;
+        failed = failed || result.failed;
+    }
+
+    std::printf("clients %d, pipeline %d, threads %d, %.2f s: %zu commands (%zu ERR), %.0f ops/s\n",
+                options.clients, options.pipeline, options.threads, elapsed, latencies.size(), errors,
+                static_cast<double>(latencies.size()) / elapsed);
+    double p50 = percentile(latencies, 0.50);
+    double p99 = percentile(latencies, 0.99);
+    double p999 = percentile(latencies, 0.999);
+    double worst = percentile(latencies, 1.0);
+    std::printf("latency p50 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n", p50, p99, p999, worst);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,171 @@
+#include "AtomicFileWriter.h"
+#include <cerrno>       // For errno / EINTR
+#include <cstdio>       // For std::rename and std::remove
+#include <filesystem>   // For finding the parent directory to fsync
+#include <fcntl.h>      // For open
+#include <unistd.h>     // For write, pwrite, fsync, ftruncate and close
+
+namespace {
+
+// fsyncs a directory so a rename inside it survives a crash
+bool syncDirectory(const std::string& filePath) {
+    std::filesystem::path parent = std::filesystem::path(filePath).parent_path();
+    int dirFd = open(parent.empty() ? "." : parent.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd < 0) {
+        return false;
+    }
+    bool ok = fsync(dirFd) == 0;
+    close(dirFd);
+    return ok;
+}
+
+} // namespace
+
+// Opens (and truncates) the temporary file next to the target, so the final rename stays on one filesystem
+AtomicFileWriter::AtomicFileWriter(const std::string& targetPath, std::string& buffer, std::size_t flushSize)
+    : targetPath(targetPath), tempPath(targetPath + ".tmp"), buffer(buffer), flushSize(flushSize),
+      fd(-1), failed(false), committed(false) {
+    buffer.clear();
+    buffer.reserve(flushSize + 4096);
+    fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+
+// An uncommitted writer cleans up after itself and leaves the target alone
+AtomicFileWriter::~AtomicFileWriter() {
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (!committed) {
+        std::remove(tempPath.c_str());
+    }
+}
+
+bool AtomicFileWriter::flush() {
+    const char* data = buffer.data();
+    std::size_t remaining = buffer.size();
+
+    while (remaining > 0 && !failed) {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            failed = true;
+        } else {
+            data += written;
+            remaining -= static_cast<std::size_t>(written);
+        }
+    }
+
+    buffer.clear(); // Keeps its capacity for the next batch
+    return !failed;
+}
+
+bool AtomicFileWriter::write(std::string_view bytes) {
+    buffer.append(bytes);
+    return flushIfFull();
+}
+
+// Everything buffered goes out first so the patched range is really on the file
+bool AtomicFileWriter::patch(std::size_t offset, std::string_view bytes) {
+    if (!good() || !flush()) {
+        return false;
+    }
+    while (!bytes.empty()) {
+        ssize_t written = pwrite(fd, bytes.data(), bytes.size(), static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            failed = true;
+            return false;
+        }
+        bytes.remove_prefix(static_cast<std::size_t>(written));
+        offset += static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+bool AtomicFileWriter::commit(bool sync) {
+    if (!good() || !flush()) {
+        return false;
+    }
+    if (sync && fsync(fd) != 0) {
+        failed = true;
+        return false;
+    }
+
+    int closeResult = close(fd);
+    fd = -1;
+    if (closeResult != 0) {
+        failed = true;
+        return false;
+    }
+
+    if (std::rename(tempPath.c_str(), targetPath.c_str()) != 0) {
+        failed = true;
+        return false;
+    }
+    committed = true;
+
+    // Make the rename itself durable
+    return !sync || syncDirectory(targetPath);
+}
+
+bool AtomicFileWriter::syncFile(const std::string& path) {
+    int fileFd = open(path.c_str(), O_RDONLY);
+    if (fileFd < 0) {
+        return false;
+    }
+    bool ok = fsync(fileFd) == 0;
+    close(fileFd);
+    return ok && syncDirectory(path);
+}
+// The file must already exist: a tail only makes sense on top of what an earlier save left
+TailFileWriter::TailFileWriter(const std::string& path, std::uint64_t offset, std::string& buffer,
+                               std::size_t flushSize)
+    : buffer(buffer), flushSize(flushSize), fd(-1), offset(offset), failed(false) {
+    buffer.clear();
+    buffer.reserve(flushSize + 4096);
+    fd = open(path.c_str(), O_WRONLY);
+}
+
+TailFileWriter::~TailFileWriter() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool TailFileWriter::flush() {
+    const char* data = buffer.data();
+    std::size_t remaining = buffer.size();
+
+    while (remaining > 0 && !failed) {
+        ssize_t written = pwrite(fd, data, remaining, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            failed = true;
+        } else {
+            data += written;
+            remaining -= static_cast<std::size_t>(written);
+            offset += static_cast<std::uint64_t>(written);
+        }
+    }
+
+    buffer.clear(); // Keeps its capacity for the next batch
+    return !failed;
+}
+
+bool TailFileWriter::commit(bool sync) {
+    if (!good() || !flush()) {
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(offset)) != 0 || (sync && fdatasync(fd) != 0)) {
+        failed = true;
+        return false;
+    }
+
+    int closeResult = close(fd);
+    fd = -1;
+    if (closeResult != 0) {
+        failed = true;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,99 @@
+#ifndef ATOMIC_FILE_WRITER_H
+#define ATOMIC_FILE_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// When file data is forced out to the disk with fsync
+enum class FsyncPolicy {
+    Always,  // Every save is fsynced before it replaces the old file (safest, slowest)
+    Never,   // Leave it to the OS (fastest, the last few seconds can be lost on power failure)
+    OnExit   // Saves aren't fsynced, but the file is synced once when the FileManager is destroyed
+};
+
+// AtomicFileWriter replaces a file without ever leaving it half-written.
+// Bytes are collected in a large buffer and written with a few big write() calls to "<target>.tmp";
+// commit() then (optionally) fsyncs it and renames it over the target, which is atomic on POSIX.
+// If commit() is never reached, the destructor deletes the temporary file and the target is untouched.
+class AtomicFileWriter {
+private:
+    std::string targetPath;   // File being replaced
+    std::string tempPath;     // Where the new contents are written first
+    std::string& buffer;      // Caller-owned buffer, so its capacity survives across saves
+    std::size_t flushSize;    // Buffer size that triggers a write()
+    int fd;                   // Descriptor of the temporary file (-1 when closed)
+    bool failed;              // Set once any system call failed
+    bool committed;           // Set once the temp file was renamed into place
+
+    // Writes the whole buffer to the temp file, retrying on short writes
+    bool flush();
+
+public:
+    AtomicFileWriter(const std::string& targetPath, std::string& buffer, std::size_t flushSize = 1 << 20);
+    ~AtomicFileWriter();
+
+    AtomicFileWriter(const AtomicFileWriter&) = delete;
+    AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+
+    // True if the temp file is open and nothing has failed so far
+    bool good() const { return fd >= 0 && !failed; }
+
+    // The buffer to append to; call flushIfFull() after each record
+    std::string& output() { return buffer; }
+
+    // Hands the buffer to the kernel once it has grown past flushSize
+    bool flushIfFull() { return buffer.size() < flushSize || flush(); }
+
+    // Appends raw bytes
+    bool write(std::string_view bytes);
+
+    // Overwrites bytes already written at the given file offset (e.g. a header filled in last)
+    bool patch(std::size_t offset, std::string_view bytes);
+
+    // Flushes, optionally fsyncs, and atomically renames the temp file over the target
+    bool commit(bool sync);
+
+    // fsyncs an existing file and its directory entry (used by FsyncPolicy::OnExit)
+    static bool syncFile(const std::string& path);
+};
+
+// TailFileWriter rewrites an existing file in place from a given offset on: bytes are collected in the same
+// kind of buffer and written with pwrite from that offset, and commit() cuts the file off where they end.
+// Everything before the offset is never touched, so the cost follows the size of the tail, not the file.
+// Unlike AtomicFileWriter it changes the live file: a crash mid-write can leave the tail (and only the tail)
+// part old, part new.
+class TailFileWriter {
+private:
+    std::string& buffer;      // Caller-owned buffer, so its capacity survives across saves
+    std::size_t flushSize;    // Buffer size that triggers a write
+    int fd;                   // Descriptor of the file (-1 if it couldn't be opened)
+    std::uint64_t offset;     // Where the next flushed byte goes
+    bool failed;              // Set once any system call failed
+
+    // Writes the whole buffer at offset, retrying on short writes
+    bool flush();
+
+public:
+    TailFileWriter(const std::string& path, std::uint64_t offset, std::string& buffer,
+                   std::size_t flushSize = 1 << 20);
+    ~TailFileWriter();
+
+    TailFileWriter(const TailFileWriter&) = delete;
+    TailFileWriter& operator=(const TailFileWriter&) = delete;
+
+    // True if the file is open and nothing has failed so far
+    bool good() const { return fd >= 0 && !failed; }
+
+    // The buffer to append to; call flushIfFull() after each record
+    std::string& output() { return buffer; }
+
+    // Hands the buffer to the kernel once it has grown past flushSize
+    bool flushIfFull() { return buffer.size() < flushSize || flush(); }
+
+    // Flushes, truncates the file after the last byte written and optionally fdatasyncs it
+    bool commit(bool sync);
+};
+
+#endif // ATOMIC_FILE_WRITER_H
\ No newline at end of file
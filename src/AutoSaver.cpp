@@ -0,0 +1,126 @@
+#include "AutoSaver.h"
+#include <vector>
+
+// The list and the file start out in sync, so nothing is written until the first change
+AutoSaver::AutoSaver(TodoList& list, const std::string& filePath, std::chrono::milliseconds flushInterval,
+                     std::size_t dirtyThreshold)
+    : list(list), file(filePath), flushInterval(flushInterval), dirtyThreshold(dirtyThreshold),
+      changedGeneration(list.getGeneration()), copiedGeneration(changedGeneration),
+      savedGeneration(changedGeneration), saveRequested(false), stopping(false) {
+    list.setObserver(this);
+    flusher = std::thread(&AutoSaver::flushLoop, this);
+}
+
+AutoSaver::~AutoSaver() {
+    stop();
+}
+
+void AutoSaver::setSaveFormat(FileFormat format) {
+    file.setSaveFormat(format);
+}
+
+void AutoSaver::setFsyncPolicy(FsyncPolicy policy) {
+    file.setFsyncPolicy(policy);
+}
+
+std::unique_lock<std::mutex> AutoSaver::lockList() {
+    return std::unique_lock<std::mutex>(listMutex);
+}
+
+void AutoSaver::noteChange() {
+    std::uint64_t generation = list.getGeneration();
+    bool wake;
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        // The interval runs from the first change the flusher hasn't copied yet
+        bool wasClean = changedGeneration <= copiedGeneration;
+        if (wasClean) {
+            firstChange = std::chrono::steady_clock::now();
+        }
+        changedGeneration = generation;
+        wake = wasClean || (dirtyThreshold > 0 && generation >= copiedGeneration + dirtyThreshold);
+    }
+    if (wake) {
+        wakeFlusher.notify_one();
+    }
+}
+
+void AutoSaver::save() {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        saveRequested = true;
+    }
+    wakeFlusher.notify_one();
+}
+
+bool AutoSaver::isClean() {
+    std::lock_guard<std::mutex> guard(mutex);
+    return savedGeneration >= changedGeneration;
+}
+
+// Only the copy is taken under the list lock; the foreground can carry on while the file is written
+bool AutoSaver::writeSnapshot() {
+    std::vector<Task> snapshot;
+    std::uint64_t generation;
+    {
+        std::lock_guard<std::mutex> listGuard(listMutex);
+        generation = list.getGeneration();
+        std::lock_guard<std::mutex> guard(mutex);
+        copiedGeneration = generation;
+        if (generation == savedGeneration) {
+            return true;  // Nothing changed since the last write
+        }
+        snapshot = list.getAllTasks();
+    }
+
+    bool ok = file.saveTasks(snapshot);
+
+    std::lock_guard<std::mutex> guard(mutex);
+    if (ok) {
+        savedGeneration = generation;
+    } else {
+        // Still dirty: try again once another interval has passed
+        copiedGeneration = savedGeneration;
+        firstChange = std::chrono::steady_clock::now();
+    }
+    return ok;
+}
+
+void AutoSaver::flushLoop() {
+    std::unique_lock<std::mutex> guard(mutex);
+    while (true) {
+        // Sleep until something changed, then give the oldest change its interval unless the threshold,
+        // a save request or stop comes first
+        wakeFlusher.wait(guard, [this] { return stopping || saveRequested || changedGeneration > copiedGeneration; });
+        wakeFlusher.wait_until(guard, firstChange + flushInterval, [this] {
+            return stopping || saveRequested ||
+                   (dirtyThreshold > 0 && changedGeneration >= copiedGeneration + dirtyThreshold);
+        });
+        if (stopping) {
+            return;  // stop() does the final write itself
+        }
+        saveRequested = false;
+
+        guard.unlock();
+        writeSnapshot();
+        guard.lock();
+    }
+}
+
+bool AutoSaver::stop() {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        stopping = true;
+    }
+    wakeFlusher.notify_one();
+    if (!flusher.joinable()) {
+        return isClean();
+    }
+    flusher.join();
+
+    {
+        std::lock_guard<std::mutex> listGuard(listMutex);
+        list.setObserver(nullptr);
+    }
+    return writeSnapshot() && isClean();
+}
@@ -0,0 +1,87 @@
+#ifndef AUTO_SAVER_H
+#define AUTO_SAVER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "FileManager.h"
+#include "TodoList.h"
+#include "TodoListObserver.h"
+
+// AutoSaver keeps a TodoList's task file up to date from a background thread, so the foreground never
+// waits on the disk. Attached as the list's observer, it notes every change; once the oldest unsaved change
+// is flushInterval old (or dirtyThreshold changes have piled up first), the flusher copies the list and
+// writes the copy out. Changes made while a write is running are coalesced into the next one, so a burst
+// of edits costs one write, and a crash loses at most the last interval's changes plus one write.
+// The flusher copies the list from its own thread, so the foreground must hold lockList() for every
+// change it makes (add, complete, remove, load, clear) and for reads that tidy the list up as they go
+// (pending/completed views, searches and time queries). Plain viewAllTasks/getTaskById reads need no lock.
+class AutoSaver : public TodoListObserver {
+private:
+    TodoList& list;
+    FileManager file;                          // Only used by the flusher (and by stop once it has exited)
+    std::chrono::milliseconds flushInterval;   // Longest a change waits before its write starts
+    std::size_t dirtyThreshold;                // Changes that start a write right away (0 = interval only)
+
+    std::mutex listMutex;                      // Held for every change to the list and while it is copied
+
+    std::mutex mutex;                          // Guards everything below
+    std::condition_variable wakeFlusher;       // Signalled on the first change, the threshold, save and stop
+    std::uint64_t changedGeneration;           // List generation after the latest change
+    std::uint64_t copiedGeneration;            // Generation of the latest copy taken (in flight or written)
+    std::uint64_t savedGeneration;             // Generation the file is known to hold
+    std::chrono::steady_clock::time_point firstChange; // When the oldest change not yet copied happened
+    bool saveRequested;                        // save() asked for a write without waiting for the interval
+    bool stopping;                             // Tells the flusher to write what's left and exit
+    std::thread flusher;
+
+    // Records a change (foreground, list lock held) and wakes the flusher if it should write now
+    void noteChange();
+
+    // Copies the list under its lock and writes the copy (skipped if the file is current); false on failure
+    bool writeSnapshot();
+
+    // Body of the flusher thread
+    void flushLoop();
+
+public:
+    // Starts watching the list; the file is assumed to hold what the list holds right now
+    AutoSaver(TodoList& list, const std::string& filePath = "data/tasks.txt",
+              std::chrono::milliseconds flushInterval = std::chrono::seconds(2), std::size_t dirtyThreshold = 1000);
+
+    // Stops the flusher after a final write and detaches from the list
+    ~AutoSaver() override;
+
+    AutoSaver(const AutoSaver&) = delete;
+    AutoSaver& operator=(const AutoSaver&) = delete;
+
+    // Chooses the format and fsync policy of the flusher's writes (call before the first change, since
+    // the flusher may be writing any time after it)
+    void setSaveFormat(FileFormat format);
+    void setFsyncPolicy(FsyncPolicy policy);
+
+    // Locks the list against the flusher's copy; hold it across any change to the list
+    std::unique_lock<std::mutex> lockList();
+
+    // Asks for a write of the current state without waiting for the interval; returns immediately
+    void save();
+
+    // True if the file holds every change made so far (nothing is waiting or being written)
+    bool isClean();
+
+    // Writes whatever is still unsaved, stops the flusher and detaches from the list; returns whether the file
+    // now holds every change. Later changes are no longer saved.
+    bool stop();
+
+    // TodoListObserver: every change just marks the list dirty
+    void onTaskAdded(const Task&) override { noteChange(); }
+    void onTaskCompleted(const Task&) override { noteChange(); }
+    void onTaskRemoved(int) override { noteChange(); }
+    void onTasksCleared() override { noteChange(); }
+};
+
+#endif // AUTO_SAVER_H
@@ -0,0 +1,34 @@
+#include "BatchRunner.h"
+#include <chrono>       // For timing the run
+#include <string>
+
+BatchRunner::BatchRunner(TodoList& todoList, FileManager& fileManager, Journal* journal, std::ostream& out)
+    : commands(todoList, fileManager, journal), out(out) {}
+
+BatchStats BatchRunner::run(std::istream& in) {
+    BatchStats stats;
+    auto start = std::chrono::steady_clock::now();
+
+    std::string line;
+    std::string output;
+    std::string error;
+    std::size_t lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        std::string_view command = CommandInterpreter::trim(line);
+        if (command.empty() || command.front() == '#') {
+            continue;
+        }
+
+        stats.commands++;
+        output.clear();
+        if (!commands.execute(command, output, error)) {
+            stats.errors++;
+            out << "line " << lineNumber << ": " << error << '\n';
+        }
+        out << output;
+    }
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
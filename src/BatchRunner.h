@@ -0,0 +1,33 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include "CommandInterpreter.h"
+
+// Totals for one batch run
+struct BatchStats {
+    std::size_t commands = 0;  // Commands executed (blank lines and # comments don't count)
+    std::size_t errors = 0;    // Commands that were unknown, malformed or failed
+    double seconds = 0.0;      // Wall-clock time spent running them
+};
+
+// BatchRunner drives a TodoList from a stream of commands instead of the interactive menu.
+// One command per line (see CommandInterpreter for the list).
+// Blank lines and lines starting with '#' are skipped. Errors are reported as "line N: ..." on the
+// output and don't stop the run. Nothing touches the console beyond the output stream it's given.
+class BatchRunner {
+private:
+    CommandInterpreter commands;
+    std::ostream& out;         // Every result and error message goes here
+
+public:
+    BatchRunner(TodoList& todoList, FileManager& fileManager, Journal* journal, std::ostream& out);
+
+    // Executes every command in the stream, in order
+    BatchStats run(std::istream& in);
+};
+
+#endif // BATCH_RUNNER_H
@@ -0,0 +1,539 @@
+#include "BinarySnapshot.h"
+#include <bit>          // For std::endian and std::rotl
+#include <cstring>      // For memcpy / memcmp
+#include <limits>       // For std::numeric_limits
+#include "Varint.h"
+
+namespace {
+
+constexpr bool nativeLittleEndian = std::endian::native == std::endian::little;
+
+// Reverses the bytes of an unsigned integer (only needed on big-endian machines)
+template <typename Unsigned>
+Unsigned swapBytes(Unsigned value) {
+    Unsigned result = 0;
+    for (std::size_t i = 0; i < sizeof(Unsigned); i++) {
+        result = (result << 8) | (value & 0xff);
+        value >>= 8;
+    }
+    return result;
+}
+
+// Appends integers to the buffer in little-endian order
+template <typename Integer>
+void putLittleEndian(std::string& out, Integer value) {
+    using Unsigned = std::make_unsigned_t<Integer>;
+    Unsigned bits = static_cast<Unsigned>(value);
+    if constexpr (!nativeLittleEndian) bits = swapBytes(bits);
+    out.append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+}
+
+// Reads one little-endian integer from unaligned memory
+template <typename Integer>
+Integer getLittleEndian(const char* data) {
+    using Unsigned = std::make_unsigned_t<Integer>;
+    Unsigned bits;
+    std::memcpy(&bits, data, sizeof(bits));
+    if constexpr (!nativeLittleEndian) bits = swapBytes(bits);
+    return static_cast<Integer>(bits);
+}
+
+// Decodes a little-endian column of Stored values into a vector of Value
+template <typename Stored, typename Value>
+void readColumn(const char* data, std::size_t count, std::vector<Value>& out) {
+    out.resize(count);
+    if constexpr (nativeLittleEndian && sizeof(Stored) == sizeof(Value)) {
+        std::memcpy(out.data(), data, count * sizeof(Stored));
+    } else {
+        for (std::size_t i = 0; i < count; i++) {
+            out[i] = static_cast<Value>(getLittleEndian<Stored>(data + i * sizeof(Stored)));
+        }
+    }
+}
+
+// Rounds a byte count up to the next multiple of 8
+std::size_t padded(std::size_t bytes) {
+    return (bytes + 7) & ~std::size_t(7);
+}
+
+// Streaming 64-bit checksum: one multiply-rotate round per 8-byte word, so it runs at several GB/s.
+// Bytes are buffered until a full word is available, so the result doesn't depend on how the
+// payload is split into update() calls.
+class Checksum {
+private:
+    std::uint64_t hash = 0x9E3779B97F4A7C15ull;
+    char pending[8];
+    std::size_t pendingSize = 0;
+    std::uint64_t totalBytes = 0;
+
+    void mix(std::uint64_t word) {
+        hash ^= word * 0x87C37B91114253D5ull;
+        hash = std::rotl(hash, 31) * 0x4CF5AD432745937Full;
+    }
+
+public:
+    void update(const char* data, std::size_t size) {
+        totalBytes += size;
+        while (pendingSize > 0 && pendingSize < 8 && size > 0) {
+            pending[pendingSize++] = *data++;
+            size--;
+        }
+        if (pendingSize == 8) {
+            mix(getLittleEndian<std::uint64_t>(pending));
+            pendingSize = 0;
+        }
+        for (; size >= 8; data += 8, size -= 8) {
+            mix(getLittleEndian<std::uint64_t>(data));
+        }
+        std::memcpy(pending, data, size);
+        pendingSize += size;
+    }
+
+    std::uint64_t finish() {
+        std::uint64_t tail = 0;
+        std::memcpy(&tail, pending, pendingSize);
+        mix(tail ^ totalBytes);
+        return hash ^ (hash >> 29);
+    }
+};
+
+// Reads one column of varints front to back
+struct VarintCursor {
+    const char* p;
+    const char* end;
+
+    bool next(std::uint64_t& value) {
+        if (p < end && (*p & 0x80) == 0) {
+            value = static_cast<std::uint8_t>(*p++);
+            return true;
+        }
+        return Varint::read(p, end, value);
+    }
+
+    // True (with the bytes in word) if the next eight varints are one byte each
+    bool nextEightAreBytes(std::uint64_t& word) const {
+        if (end - p < 8) {
+            return false;
+        }
+        word = getLittleEndian<std::uint64_t>(p);
+        return (word & 0x8080808080808080ull) == 0;
+    }
+
+    bool atEnd() const { return p == end; }
+};
+
+// Section layout shared by the reader
+struct Layout {
+    std::uint32_t version = 0;
+    std::size_t count = 0;
+    std::size_t statusOffset = 0, blobOffset = 0, blobSize = 0, end = 0;
+    std::size_t idsOffset = 0, createdOffset = 0, completedOffset = 0, lengthsOffset = 0;
+    std::size_t idsSize = 0, createdSize = 0, completedSize = 0, lengthsSize = 0;  // Version 2 only
+};
+
+// Validates the header, section bounds and checksum; fills in where each column lives
+bool parseLayout(std::string_view contents, Layout& layout, std::string& error) {
+    if (!BinarySnapshot::isBinarySnapshot(contents) || contents.size() < BinarySnapshot::headerSize) {
+        error = "Not a binary task snapshot";
+        return false;
+    }
+
+    const char* data = contents.data();
+    std::uint32_t version = getLittleEndian<std::uint32_t>(data + 8);
+    std::uint64_t count = getLittleEndian<std::uint64_t>(data + 16);
+    std::uint64_t blobSize = getLittleEndian<std::uint64_t>(data + 24);
+    std::uint64_t checksum = getLittleEndian<std::uint64_t>(data + 32);
+
+    if (version != 1 && version != 2) {
+        error = "Unsupported snapshot version " + std::to_string(version);
+        return false;
+    }
+
+    // Each task takes at least 24 bytes in version 1 and 3 in version 2, which bounds the count before any
+    // size arithmetic can overflow
+    std::size_t available = contents.size() - BinarySnapshot::headerSize;
+    if (count > available / (version == 1 ? 24 : 3) || blobSize > available) {
+        error = "Snapshot header doesn't match the file size";
+        return false;
+    }
+
+    layout.version = version;
+    layout.count = count;
+    layout.blobSize = blobSize;
+    if (version == 1) {
+        layout.idsOffset = BinarySnapshot::headerSize;
+        layout.statusOffset = layout.idsOffset + padded(count * 4);
+        layout.createdOffset = layout.statusOffset + padded((count + 7) / 8);
+        layout.completedOffset = layout.createdOffset + count * 8;
+        layout.lengthsOffset = layout.completedOffset + count * 8;
+        layout.blobOffset = layout.lengthsOffset + padded(count * 4);
+    } else {
+        if (available < BinarySnapshot::sectionTableSize) {
+            error = "Snapshot is truncated";
+            return false;
+        }
+        std::size_t* sizes[] = {&layout.idsSize, &layout.createdSize, &layout.completedSize, &layout.lengthsSize};
+        for (std::size_t i = 0; i < 4; i++) {
+            std::uint64_t size = getLittleEndian<std::uint64_t>(data + BinarySnapshot::headerSize + i * 8);
+            if (size > available) {
+                error = "Snapshot header doesn't match the file size";
+                return false;
+            }
+            *sizes[i] = size;
+        }
+        layout.statusOffset = BinarySnapshot::headerSize + BinarySnapshot::sectionTableSize;
+        layout.idsOffset = layout.statusOffset + padded((count + 7) / 8);
+        layout.createdOffset = layout.idsOffset + padded(layout.idsSize);
+        layout.completedOffset = layout.createdOffset + padded(layout.createdSize);
+        layout.lengthsOffset = layout.completedOffset + padded(layout.completedSize);
+        layout.blobOffset = layout.lengthsOffset + padded(layout.lengthsSize);
+    }
+    layout.end = layout.blobOffset + padded(blobSize);
+
+    if (layout.end > contents.size()) {
+        error = "Snapshot is truncated";
+        return false;
+    }
+
+    Checksum actual;
+    actual.update(data + BinarySnapshot::headerSize, layout.end - BinarySnapshot::headerSize);
+    if (actual.finish() != checksum) {
+        error = "Snapshot checksum mismatch (file is corrupted)";
+        return false;
+    }
+    return true;
+}
+
+// True if task i is completed in the status bitmap (bit i of byte i/8)
+bool statusBit(const char* status, std::size_t i) {
+    return (status[i / 8] >> (i % 8)) & 1;
+}
+
+// Where decodePacked puts each task: straight into a TaskRecord...
+struct RecordSink {
+    std::vector<TaskRecord>& records;
+    const char* blob;
+    const char* status;
+
+    void put(std::size_t i, int id, time_t created, time_t completed, std::size_t offset, std::uint32_t length) {
+        TaskRecord& record = records[i];
+        record.id = id;
+        record.description = std::string_view(blob + offset, length);
+        record.completed = statusBit(status, i);
+        record.creationDate = created;
+        record.completionDate = completed;
+    }
+};
+
+// ...or into the columns a TaskStore adopts
+struct ColumnSink {
+    std::vector<int> ids;
+    std::vector<time_t> creationDates;
+    std::vector<time_t> completionDates;
+    std::vector<std::uint32_t> lengths;
+
+    void put(std::size_t i, int id, time_t created, time_t completed, std::size_t, std::uint32_t length) {
+        ids[i] = id;
+        creationDates[i] = created;
+        completionDates[i] = completed;
+        lengths[i] = length;
+    }
+};
+
+// Decodes the version 2 sections into the sink in one pass over the tasks, so each task is written once.
+// Most varints are one byte (IDs step by one, tasks are created seconds apart, descriptions are short):
+// whenever the next eight IDs, creation dates and lengths all are, the eight tasks are decoded from three
+// 64-bit loads with no per-byte checks. Every section must be used up exactly and the lengths must exactly
+// fill the blob.
+template <typename Sink>
+bool decodePacked(const char* data, const Layout& layout, Sink& sink, std::string& error) {
+    auto cursor = [data](std::size_t offset, std::size_t size) {
+        return VarintCursor{data + offset, data + offset + size};
+    };
+    VarintCursor ids = cursor(layout.idsOffset, layout.idsSize);
+    VarintCursor created = cursor(layout.createdOffset, layout.createdSize);
+    VarintCursor completed = cursor(layout.completedOffset, layout.completedSize);
+    VarintCursor lengths = cursor(layout.lengthsOffset, layout.lengthsSize);
+    const char* status = data + layout.statusOffset;
+
+    std::uint64_t id = 0, date = 0;
+    std::size_t blobUsed = 0;
+    bool ok = true;
+
+    // Completion dates exist only for completed tasks, as the distance from the task's creation date
+    auto emit = [&](std::size_t i, std::uint64_t length) {
+        std::uint64_t completion = 0;
+        if (statusBit(status, i)) {
+            std::uint64_t code = 0;
+            ok = ok && completed.next(code);
+            if (ok) completion = date + Varint::unzigzag(code);
+        }
+        if (length > std::numeric_limits<std::uint32_t>::max() || length > layout.blobSize - blobUsed) {
+            ok = false;
+            return;
+        }
+        sink.put(i, static_cast<int>(id), static_cast<time_t>(date), ok ? static_cast<time_t>(completion) : 0,
+                 blobUsed, static_cast<std::uint32_t>(length));
+        blobUsed += length;
+    };
+
+    std::size_t i = 0;
+    while (ok && i < layout.count) {
+        std::uint64_t idWord, dateWord, lengthWord;
+        if (layout.count - i >= 8 && ids.nextEightAreBytes(idWord) && created.nextEightAreBytes(dateWord) &&
+            lengths.nextEightAreBytes(lengthWord)) {
+            for (std::size_t k = 0; k < 8; k++) {
+                id += Varint::unzigzag((idWord >> (8 * k)) & 0x7f);
+                date += Varint::unzigzag((dateWord >> (8 * k)) & 0x7f);
+                emit(i + k, (lengthWord >> (8 * k)) & 0x7f);
+            }
+            ids.p += 8;
+            created.p += 8;
+            lengths.p += 8;
+            i += 8;
+            continue;
+        }
+
+        std::uint64_t idCode, dateCode, length;
+        ok = ids.next(idCode) && created.next(dateCode) && lengths.next(length);
+        if (ok) {
+            id += Varint::unzigzag(idCode);
+            date += Varint::unzigzag(dateCode);
+            emit(i, length);
+        }
+        i++;
+    }
+
+    ok = ok && ids.atEnd() && created.atEnd() && completed.atEnd() && lengths.atEnd() &&
+         blobUsed == layout.blobSize;
+    if (!ok) {
+        error = "Snapshot columns are corrupted";
+    }
+    return ok;
+}
+
+// Checks that the description lengths exactly fill the blob
+bool checkLengths(const Layout& layout, const std::vector<std::uint32_t>& lengths, std::string& error) {
+    std::uint64_t total = 0;
+    for (std::uint32_t length : lengths) {
+        total += length;
+    }
+    if (total != layout.blobSize) {
+        error = "Snapshot description lengths don't match the blob size";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool BinarySnapshot::isBinarySnapshot(std::string_view contents) {
+    return contents.size() >= sizeof(magic) && std::memcmp(contents.data(), magic, sizeof(magic)) == 0;
+}
+
+// Sizes every section in a first pass (so the section table can go through the checksum in order), writes the
+// header with a zero checksum, streams the sections, then patches the real checksum in
+bool BinarySnapshot::write(AtomicFileWriter& writer, const TaskView& tasks) {
+    std::size_t count = tasks.size();
+    std::uint64_t blobSize = 0;
+    std::uint64_t idsSize = 0, createdSize = 0, completedSize = 0, lengthsSize = 0;
+    int previousId = 0;
+    time_t previousCreated = 0;
+    for (const Task& task : tasks) {
+        std::size_t length = task.getDescriptionView().size();
+        if (length > std::numeric_limits<std::uint32_t>::max()) {
+            return false; // Doesn't fit the 32-bit description lengths
+        }
+        blobSize += length;
+        idsSize += Varint::size(Varint::deltaCode(task.getId(), previousId));
+        createdSize += Varint::size(Varint::deltaCode(task.getCreationDate(), previousCreated));
+        if (task.isCompleted()) {
+            completedSize += Varint::size(Varint::deltaCode(task.getCompletionDate(), task.getCreationDate()));
+        }
+        lengthsSize += Varint::size(length);
+        previousId = task.getId();
+        previousCreated = task.getCreationDate();
+    }
+
+    std::string& out = writer.output();
+    out.append(magic, sizeof(magic));
+    putLittleEndian<std::uint32_t>(out, currentVersion);
+    putLittleEndian<std::uint32_t>(out, 0); // flags (none defined yet)
+    putLittleEndian<std::uint64_t>(out, count);
+    putLittleEndian<std::uint64_t>(out, blobSize);
+    putLittleEndian<std::uint64_t>(out, 0); // checksum, patched below
+
+    // Everything after the header goes through the checksum as it leaves the buffer
+    Checksum checksum;
+    std::size_t payloadBytes = 0;
+    std::size_t checkedUpTo = out.size();
+    auto flushChecked = [&]() {
+        checksum.update(out.data() + checkedUpTo, out.size() - checkedUpTo);
+        payloadBytes += out.size() - checkedUpTo;
+        bool ok = writer.flushIfFull();
+        checkedUpTo = out.size();
+        return ok;
+    };
+    auto pad = [&]() {
+        std::size_t before = payloadBytes + (out.size() - checkedUpTo);
+        out.append(padded(before) - before, '\0');
+        return flushChecked();
+    };
+
+    putLittleEndian<std::uint64_t>(out, idsSize);
+    putLittleEndian<std::uint64_t>(out, createdSize);
+    putLittleEndian<std::uint64_t>(out, completedSize);
+    putLittleEndian<std::uint64_t>(out, lengthsSize);
+    if (!flushChecked()) return false;
+
+    std::uint8_t bits = 0;
+    std::size_t index = 0;
+    for (const Task& task : tasks) {
+        bits |= static_cast<std::uint8_t>(task.isCompleted()) << (index % 8);
+        if (++index % 8 == 0) {
+            out += static_cast<char>(bits);
+            bits = 0;
+            if (!flushChecked()) return false;
+        }
+    }
+    if (index % 8 != 0) {
+        out += static_cast<char>(bits);
+    }
+    if (!pad()) return false;
+
+    previousId = 0;
+    for (const Task& task : tasks) {
+        Varint::put(out, Varint::deltaCode(task.getId(), previousId));
+        previousId = task.getId();
+        if (!flushChecked()) return false;
+    }
+    if (!pad()) return false;
+
+    previousCreated = 0;
+    for (const Task& task : tasks) {
+        Varint::put(out, Varint::deltaCode(task.getCreationDate(), previousCreated));
+        previousCreated = task.getCreationDate();
+        if (!flushChecked()) return false;
+    }
+    if (!pad()) return false;
+
+    for (const Task& task : tasks) {
+        if (task.isCompleted()) {
+            Varint::put(out, Varint::deltaCode(task.getCompletionDate(), task.getCreationDate()));
+            if (!flushChecked()) return false;
+        }
+    }
+    if (!pad()) return false;
+
+    for (const Task& task : tasks) {
+        Varint::put(out, task.getDescriptionView().size());
+        if (!flushChecked()) return false;
+    }
+    if (!pad()) return false;
+
+    for (const Task& task : tasks) {
+        out += task.getDescriptionView();
+        if (!flushChecked()) return false;
+    }
+    if (!pad()) return false;
+
+    std::string header;
+    putLittleEndian<std::uint64_t>(header, checksum.finish());
+    return writer.patch(32, header);
+}
+
+bool BinarySnapshot::read(std::string_view contents, std::vector<Task>& tasks, std::string& error) {
+    std::vector<TaskRecord> records;
+    if (!read(contents, records, error)) {
+        return false;
+    }
+
+    tasks.clear();
+    tasks.reserve(records.size());
+    for (const TaskRecord& record : records) {
+        tasks.emplace_back(record);
+    }
+    return true;
+}
+
+bool BinarySnapshot::read(std::string_view contents, std::vector<TaskRecord>& records, std::string& error) {
+    Layout layout;
+    if (!parseLayout(contents, layout, error)) {
+        return false;
+    }
+
+    const char* data = contents.data();
+    const char* blob = data + layout.blobOffset;
+    const char* status = data + layout.statusOffset;
+    records.clear();
+    records.resize(layout.count);
+    if (layout.version == 1) {
+        std::vector<std::uint32_t> lengths;
+        readColumn<std::uint32_t>(data + layout.lengthsOffset, layout.count, lengths);
+        if (!checkLengths(layout, lengths, error)) {
+            return false;
+        }
+        for (std::size_t i = 0; i < layout.count; i++) {
+            TaskRecord& record = records[i];
+            record.id = getLittleEndian<std::int32_t>(data + layout.idsOffset + i * 4);
+            record.completed = statusBit(status, i);
+            record.creationDate = static_cast<time_t>(getLittleEndian<std::int64_t>(data + layout.createdOffset + i * 8));
+            record.completionDate = static_cast<time_t>(getLittleEndian<std::int64_t>(data + layout.completedOffset + i * 8));
+            record.description = std::string_view(blob, lengths[i]);
+            blob += lengths[i];
+        }
+    } else {
+        RecordSink sink{records, blob, status};
+        if (!decodePacked(data, layout, sink, error)) {
+            return false;
+        }
+    }
+
+    for (const TaskRecord& record : records) {
+        if (record.id <= 0) {
+            error = "Snapshot contains an invalid task ID";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Column for column: version 1 sections are bulk copies, version 2 ones are decoded into the store's columns
+bool BinarySnapshot::read(std::string_view contents, TaskStore& store, std::string& error) {
+    Layout layout;
+    if (!parseLayout(contents, layout, error)) {
+        return false;
+    }
+
+    const char* data = contents.data();
+    ColumnSink columns;
+    if (layout.version == 1) {
+        readColumn<std::int32_t>(data + layout.idsOffset, layout.count, columns.ids);
+        readColumn<std::int64_t>(data + layout.createdOffset, layout.count, columns.creationDates);
+        readColumn<std::int64_t>(data + layout.completedOffset, layout.count, columns.completionDates);
+        readColumn<std::uint32_t>(data + layout.lengthsOffset, layout.count, columns.lengths);
+        if (!checkLengths(layout, columns.lengths, error)) {
+            return false;
+        }
+    } else {
+        columns.ids.resize(layout.count);
+        columns.creationDates.resize(layout.count);
+        columns.completionDates.resize(layout.count);
+        columns.lengths.resize(layout.count);
+        if (!decodePacked(data, layout, columns, error)) {
+            return false;
+        }
+    }
+
+    // The status bitmap is stored byte-wise; the store keeps it as 64-bit words
+    std::vector<std::uint64_t> completedBits((layout.count + 63) / 64, 0);
+    for (std::size_t byte = 0; byte < (layout.count + 7) / 8; byte++) {
+        completedBits[byte / 8] |= std::uint64_t(static_cast<std::uint8_t>(data[layout.statusOffset + byte]))
+                                   << (8 * (byte % 8));
+    }
+
+    store.adoptColumns(std::move(columns.ids), std::move(completedBits), std::move(columns.creationDates),
+                       std::move(columns.completionDates), std::move(columns.lengths),
+                       std::string(data + layout.blobOffset, layout.blobSize));
+    return true;
+}
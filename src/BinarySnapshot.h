@@ -0,0 +1,54 @@
+#ifndef BINARY_SNAPSHOT_H
+#define BINARY_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "AtomicFileWriter.h"
+#include "Task.h"
+#include "TaskStore.h"
+#include "TaskView.h"
+
+// BinarySnapshot reads and writes the binary task file format.
+// All fixed-size integers are little-endian and every section starts on an 8-byte boundary.
+// Version 2 (written) stores the columns as LEB128 varints (see Varint.h):
+//
+//   header (40 bytes)  magic "TODOSNAP", uint32 version, uint32 flags,
+//                      uint64 task count, uint64 description blob size, uint64 payload checksum
+//   section table      uint64 x 4: byte sizes of the ids, creation dates, completion dates and lengths
+//   status             1 bit per task (bit i of byte i/8 = task i is completed)
+//   ids                zigzag varint: difference from the previous task's ID (the first from 0)
+//   creation dates     zigzag varint: difference from the previous task's creation date
+//   completion dates   zigzag varint: difference from the task's own creation date, completed tasks only
+//   lengths            varint x count (description length in bytes)
+//   blob               every description back to back
+//
+// IDs are sequential and tasks are created in order, so those columns are mostly one byte per task
+// (version 1 spent 4 + 8 + 8 + 4 fixed bytes), and pending tasks store no completion date at all (they load
+// with 0). The loader decodes runs of one-byte varints eight at a time.
+// Version 1 (still read) stored int32 ids, then the status bitmap, int64 creation and completion dates and
+// uint32 lengths for every task, with no section table.
+//
+// Descriptions are length-prefixed, so any byte (including '|' and newlines) round-trips.
+class BinarySnapshot {
+public:
+    static constexpr char magic[8] = {'T', 'O', 'D', 'O', 'S', 'N', 'A', 'P'};
+    static constexpr std::uint32_t currentVersion = 2;
+    static constexpr std::size_t headerSize = 40;
+    static constexpr std::size_t sectionTableSize = 32;  // Version 2 only
+
+    // True if the bytes start with the binary snapshot magic number
+    static bool isBinarySnapshot(std::string_view contents);
+
+    // Writes a full snapshot of the tasks through the writer (the caller commits it)
+    static bool write(AtomicFileWriter& writer, const TaskView& tasks);
+
+    // Decodes a snapshot into Task objects / a TaskStore; on failure returns false and sets error
+    static bool read(std::string_view contents, std::vector<Task>& tasks, std::string& error);
+    static bool read(std::string_view contents, std::vector<TaskRecord>& records, std::string& error); // Descriptions point into contents
+    static bool read(std::string_view contents, TaskStore& store, std::string& error);
+};
+
+#endif // BINARY_SNAPSHOT_H
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "CommandInterpreter.h"
+#include "Metrics.h"
+#include <charconv>     // For std::from_chars / std::to_chars on task IDs and counts
+
+namespace {
+
+// Parses a whole argument as a task ID; false if it isn't one
+bool parseId(std::string_view text, int& id) {
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), id);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+// Appends a number without going through a stream
+void appendNumber(std::string& output, long long value) {
+    char digits[24];
+    auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+    output.append(digits, end);
+}
+
+void appendTask(std::string& output, const Task& task) {
+    appendNumber(output, task.getId());
+    output += task.isCompleted() ? "|DONE|" : "|PENDING|";
+    output += task.getDescription();
+    output += '\n';
+}
+
+} // namespace
+
+CommandInterpreter::CommandInterpreter(TodoList& todoList, FileManager& fileManager, Journal* journal)
+    : todoList(todoList), fileManager(fileManager), journal(journal) {}
+
+std::string_view CommandInterpreter::trim(std::string_view text) {
+    std::size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    std::size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+bool CommandInterpreter::execute(std::string_view command, std::string& output, std::string& error) {
+    // Split into the verb and the (trimmed) rest of the line
+    std::size_t space = command.find_first_of(" \t");
+    std::string_view verb = command.substr(0, space);
+    std::string_view argument = space == std::string_view::npos ? std::string_view() : trim(command.substr(space));
+
+    if (verb == "add") {
+        if (argument.empty()) {
+            error = "add needs a description";
+            return false;
+        }
+        todoList.addTask(std::string(argument));
+        return true;
+    }
+
+    if (verb == "done" || verb == "rm" || verb == "get") {
+        int id;
+        if (!parseId(argument, id)) {
+            error = std::string(verb) + " needs a task ID";
+            return false;
+        }
+        bool found;
+        if (verb == "get") {
+            const Task* task = todoList.getTaskById(id);
+            found = task != nullptr;
+            if (found) {
+                appendTask(output, *task);
+            }
+        } else {
+            found = verb == "done" ? todoList.markTaskAsCompleted(id) : todoList.removeTask(id);
+        }
+        if (!found) {
+            error = "no task found with ID: " + std::to_string(id);
+        }
+        return found;
+    }
+
+    if (verb == "count") {
+        appendNumber(output, todoList.getTaskCount());
+        output += ' ';
+        appendNumber(output, todoList.getPendingCount());
+        output += ' ';
+        appendNumber(output, todoList.getCompletedCount());
+        output += '\n';
+        return true;
+    }
+
+    if (verb == "list") {
+        if (argument.empty() || argument == "all") {
+            list(todoList.viewAllTasks(), output);
+        } else if (argument == "pending") {
+            list(todoList.viewPendingTasks(), output);
+        } else if (argument == "completed") {
+            list(todoList.viewCompletedTasks(), output);
+        } else {
+            error = "list takes all, pending or completed";
+            return false;
+        }
+        return true;
+    }
+
+    if (verb == "search") {
+        if (argument.empty()) {
+            error = "search needs a query";
+            return false;
+        }
+        list(todoList.search(TaskQuery::parse(argument)), output);
+        return true;
+    }
+
+    if (verb == "save") {
+        bool saved = journal ? journal->compact() && journal->waitForCompaction()
+                             : fileManager.saveTasks(todoList);
+        if (!saved) {
+            error = "failed to save tasks";
+        }
+        return saved;
+    }
+
+    if (verb == "load") {
+        if (journal) {
+            std::size_t replayed = 0;
+            if (!journal->recover(todoList, replayed)) {
+                error = "failed to read the snapshot (journaling stopped, files left untouched)";
+                return false;
+            }
+        } else if (!fileManager.loadInto(todoList)) {
+            error = "failed to load tasks";
+            return false;
+        }
+        return true;
+    }
+
+    if (verb == "metrics") {
+        if (!Metrics::enabled()) {
+            error = "metrics are compiled out (build with TODO_METRICS)";
+            return false;
+        }
+        if (argument.empty() || argument == "prometheus") {
+            output += Metrics::toPrometheus();
+        } else if (argument == "json") {
+            output += Metrics::toJson();
+            output += '\n';
+        } else {
+            error = "metrics takes prometheus or json";
+            return false;
+        }
+        return true;
+    }
+
+    if (verb == "clear") {
+        todoList.clearAllTasks();
+        return true;
+    }
+
+    error = "unknown command: " + std::string(verb);
+    return false;
+}
+
+void CommandInterpreter::list(const TaskView& tasks, std::string& output) {
+    for (const Task& task : tasks) {
+        appendTask(output, task);
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef COMMAND_INTERPRETER_H
+#define COMMAND_INTERPRETER_H
+
+#include <string>
+#include <string_view>
+#include "TodoList.h"
+#include "FileManager.h"
+#include "Journal.h"
+
+// CommandInterpreter runs the one-line text commands shared by batch mode and the server:
+//   add <description>              add a pending task
+//   done <id>                      mark a task as completed
+//   rm <id>                        remove a task
+//   get <id>                       print one task
+//   count                          print "<total> <pending> <completed>"
+//   list [all|pending|completed]   print tasks (defaults to all)
+//   search <query>                 print matching tasks (syntax: see TaskQuery::parse)
+//   save                           save to the task file (or compact the journal, if there is one)
+//   load                           reload from the task file (or replay the journal)
+//   metrics [prometheus|json]      print the instrumentation counters (see Metrics)
+//   clear                          remove every task
+// Tasks are printed one per line as id|DONE|description or id|PENDING|description.
+// Results are appended to a caller-owned string, so a caller answering many commands reuses one buffer.
+class CommandInterpreter {
+private:
+    TodoList& todoList;
+    FileManager& fileManager;
+    Journal* journal;          // Used for save/load when set (nullptr = plain file)
+
+    // Appends one line per task
+    static void list(const TaskView& tasks, std::string& output);
+
+public:
+    CommandInterpreter(TodoList& todoList, FileManager& fileManager, Journal* journal);
+
+    // Runs one trimmed, non-empty command. Results are appended to output; on failure, returns false and
+    // sets error to a one-line message (without a newline).
+    bool execute(std::string_view command, std::string& output, std::string& error);
+
+    // Strips spaces, tabs and a trailing '\r' from both ends
+    static std::string_view trim(std::string_view text);
+};
+
+#endif // COMMAND_INTERPRETER_H
@@ -0,0 +1,331 @@
+#include "CompressedText.h"
+#include <algorithm>    // For std::max / std::min
+#include <cerrno>       // For errno / EINTR
+#include <cstring>      // For memcmp
+#include <exception>    // For std::exception (allocation failures on worker threads)
+#include <thread>       // For the compression / decompression threads
+#include <unistd.h>     // For read
+#ifdef TODO_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+constexpr const char* unsupported = "compressed task files need a build with zstd support";
+
+#ifdef TODO_ZSTD
+
+unsigned resolveThreads(unsigned threadCount) {
+    return threadCount > 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+}
+
+struct CompressContextDeleter {
+    void operator()(ZSTD_CCtx* context) const { ZSTD_freeCCtx(context); }
+};
+struct DecompressContextDeleter {
+    void operator()(ZSTD_DCtx* context) const { ZSTD_freeDCtx(context); }
+};
+using CompressContext = std::unique_ptr<ZSTD_CCtx, CompressContextDeleter>;
+using DecompressContext = std::unique_ptr<ZSTD_DCtx, DecompressContextDeleter>;
+
+// Compresses one chunk of text into a single frame (which records the chunk's size); false on failure
+bool compressFrame(ZSTD_CCtx* context, const std::string& text, std::string& frame) {
+    try {
+        frame.resize(ZSTD_compressBound(text.size()));
+        std::size_t size = ZSTD_compressCCtx(context, frame.data(), frame.size(), text.data(), text.size(),
+                                             CompressedText::level);
+        if (ZSTD_isError(size)) {
+            return false;
+        }
+        frame.resize(size);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// One frame of the input and where its text goes in the output
+struct Frame {
+    std::string_view input;
+    std::size_t offset;
+    std::size_t size;
+};
+
+// Decompresses a run of frames into their slices of text; returns an empty string or the error
+std::string decompressFrames(const Frame* frames, std::size_t count, char* text) {
+    DecompressContext context(ZSTD_createDCtx());
+    if (!context) {
+        return "out of memory";
+    }
+    for (std::size_t i = 0; i < count; i++) {
+        const Frame& frame = frames[i];
+        std::size_t size = ZSTD_decompressDCtx(context.get(), text + frame.offset, frame.size,
+                                               frame.input.data(), frame.input.size());
+        if (ZSTD_isError(size)) {
+            return ZSTD_getErrorName(size);
+        }
+        if (size != frame.size) {
+            return "frame shorter than its recorded size";
+        }
+    }
+    return std::string();
+}
+
+// Decompresses frames that don't record their size (e.g. `zstd` fed from a pipe) by growing the text as it goes
+bool decompressStreaming(std::string_view contents, std::string& text, std::string& error) {
+    DecompressContext context(ZSTD_createDCtx());
+    if (!context) {
+        error = "out of memory";
+        return false;
+    }
+    text.clear();
+    ZSTD_inBuffer input = {contents.data(), contents.size(), 0};
+    std::size_t result = 0;
+    while (input.pos < input.size || result != 0) {
+        std::size_t used = text.size();
+        text.resize(std::max(used + ZSTD_DStreamOutSize(), used * 2));
+        ZSTD_outBuffer output = {text.data() + used, text.size() - used, 0};
+        result = ZSTD_decompressStream(context.get(), &output, &input);
+        text.resize(used + output.pos);
+        if (ZSTD_isError(result)) {
+            error = ZSTD_getErrorName(result);
+            return false;
+        }
+        if (input.pos == input.size && output.pos == 0 && result != 0) {
+            error = "compressed file is truncated";
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif // TODO_ZSTD
+
+} // namespace
+
+bool CompressedText::available() {
+#ifdef TODO_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool CompressedText::isCompressed(std::string_view contents) {
+    return contents.size() >= sizeof(magic) && std::memcmp(contents.data(), magic, sizeof(magic)) == 0;
+}
+
+bool CompressedText::hasCompressedExtension(std::string_view path) {
+    return path.size() > 4 && path.substr(path.size() - 4) == ".zst";
+}
+
+// Chunks are filled one after another; once every thread has a full one, the batch is compressed in parallel
+// and the frames are written in order
+bool CompressedText::write(AtomicFileWriter& writer, const TaskView& tasks, unsigned threadCount) {
+#ifdef TODO_ZSTD
+    threadCount = resolveThreads(threadCount);
+    std::vector<std::string> chunks(threadCount);
+    std::vector<std::string> frames(threadCount);
+    std::vector<CompressContext> contexts(threadCount);
+    for (auto& context : contexts) {
+        context.reset(ZSTD_createCCtx());
+        if (!context) {
+            return false;
+        }
+    }
+
+    auto compressBatch = [&](std::size_t count) {
+        std::vector<char> ok(count, 0);
+        std::vector<std::thread> workers;
+        for (std::size_t i = 1; i < count; i++) {
+            workers.emplace_back([&, i] { ok[i] = compressFrame(contexts[i].get(), chunks[i], frames[i]); });
+        }
+        ok[0] = compressFrame(contexts[0].get(), chunks[0], frames[0]);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            if (!ok[i] || !writer.write(frames[i])) {
+                return false;
+            }
+            chunks[i].clear();
+        }
+        return true;
+    };
+
+    std::size_t filled = 0;  // Chunks before this one are full
+    chunks[0].reserve(chunkSize + 4096);
+    for (const auto& task : tasks) {
+        std::string& chunk = chunks[filled];
+        task.appendTo(chunk);
+        chunk += '\n';
+        if (chunk.size() >= chunkSize) {
+            if (++filled == threadCount) {
+                if (!compressBatch(filled)) {
+                    return false;
+                }
+                filled = 0;
+            }
+            chunks[filled].reserve(chunkSize + 4096);
+        }
+    }
+    if (!chunks[filled].empty()) {
+        filled++;
+    }
+    return filled == 0 || compressBatch(filled);
+#else
+    (void)writer;
+    (void)tasks;
+    (void)threadCount;
+    return false;
+#endif
+}
+
+bool CompressedText::decompress(std::string_view contents, std::string& text, unsigned threadCount,
+                                std::string& error) {
+#ifdef TODO_ZSTD
+    // Walk the frame headers to find every frame and its decompressed size
+    std::vector<Frame> frames;
+    std::size_t total = 0;
+    for (std::string_view rest = contents; !rest.empty();) {
+        std::size_t frameSize = ZSTD_findFrameCompressedSize(rest.data(), rest.size());
+        if (ZSTD_isError(frameSize)) {
+            error = std::string("corrupt or truncated compressed file: ") + ZSTD_getErrorName(frameSize);
+            return false;
+        }
+        unsigned long long contentSize = ZSTD_getFrameContentSize(rest.data(), rest.size());
+        if (contentSize == ZSTD_CONTENTSIZE_ERROR) {
+            error = "corrupt compressed file: bad frame header";
+            return false;
+        }
+        if (contentSize == ZSTD_CONTENTSIZE_UNKNOWN) {
+            return decompressStreaming(contents, text, error);
+        }
+        // The size is only the header's word for it: don't allocate more than the blocks could produce
+        if (contentSize / CompressedText::maxRatio >= frameSize) {
+            error = "corrupt compressed file: a frame declares more text than it could hold";
+            return false;
+        }
+        frames.push_back({rest.substr(0, frameSize), total, static_cast<std::size_t>(contentSize)});
+        total += static_cast<std::size_t>(contentSize);
+        rest.remove_prefix(frameSize);
+    }
+
+    // Every frame knows where its text goes, so runs of frames decompress independently
+    text.resize(total);
+    std::size_t groups = std::min<std::size_t>(resolveThreads(threadCount), frames.size());
+    std::vector<std::string> errors(groups);
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < groups; i++) {
+        std::size_t first = frames.size() * i / groups;
+        std::size_t last = frames.size() * (i + 1) / groups;
+        workers.emplace_back([&, i, first, last] {
+            errors[i] = decompressFrames(frames.data() + first, last - first, text.data());
+        });
+    }
+    if (groups > 0) {
+        errors[0] = decompressFrames(frames.data(), frames.size() / groups, text.data());
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& message : errors) {
+        if (!message.empty()) {
+            error = "corrupt compressed file: " + message;
+            return false;
+        }
+    }
+    return true;
+#else
+    (void)contents;
+    (void)text;
+    (void)threadCount;
+    error = unsupported;
+    return false;
+#endif
+}
+
+#ifdef TODO_ZSTD
+
+struct CompressedText::StreamDecoder::State {
+    int fd;
+    DecompressContext context;
+    std::vector<char> input;    // Compressed bytes read but not all consumed yet
+    ZSTD_inBuffer in;           // The unconsumed part of input
+    bool inputDone;             // True once read() returned 0
+    bool frameDone;             // True if the last frame decoded so far is complete and flushed
+    std::string error;
+};
+
+CompressedText::StreamDecoder::StreamDecoder(int fd, std::string_view head) : state(std::make_unique<State>()) {
+    state->fd = fd;
+    state->context.reset(ZSTD_createDCtx());
+    state->input.assign(head.begin(), head.end());
+    state->input.resize(std::max(head.size(), ZSTD_DStreamInSize()));
+    state->in = {state->input.data(), head.size(), 0};
+    state->inputDone = false;
+    state->frameDone = false;
+    if (!state->context) {
+        state->error = "out of memory";
+    }
+}
+
+long CompressedText::StreamDecoder::read(char* out, std::size_t capacity) {
+    State& s = *state;
+    if (!s.error.empty()) {
+        return -1;
+    }
+    ZSTD_outBuffer output = {out, capacity, 0};
+    while (true) {
+        if (s.in.pos == s.in.size && !s.inputDone) {
+            ssize_t bytes;
+            do {
+                bytes = ::read(s.fd, s.input.data(), s.input.size());
+            } while (bytes < 0 && errno == EINTR);
+            if (bytes < 0) {
+                s.error = std::string("read failed: ") + std::strerror(errno);
+                return -1;
+            }
+            s.inputDone = bytes == 0;
+            s.in = {s.input.data(), static_cast<std::size_t>(bytes), 0};
+        }
+        if (s.in.pos == s.in.size && s.inputDone && s.frameDone) {
+            return 0;
+        }
+
+        // Called even with no input left, so output zstd is still holding back gets flushed
+        std::size_t result = ZSTD_decompressStream(s.context.get(), &output, &s.in);
+        if (ZSTD_isError(result)) {
+            s.error = std::string("corrupt compressed file: ") + ZSTD_getErrorName(result);
+            return -1;
+        }
+        s.frameDone = result == 0;
+        if (output.pos > 0) {
+            return static_cast<long>(output.pos);
+        }
+        if (s.in.pos == s.in.size && s.inputDone) {
+            s.error = "compressed file is truncated";
+            return -1;
+        }
+    }
+}
+
+#else
+
+struct CompressedText::StreamDecoder::State {
+    std::string error = unsupported;
+};
+
+CompressedText::StreamDecoder::StreamDecoder(int, std::string_view) : state(std::make_unique<State>()) {}
+
+long CompressedText::StreamDecoder::read(char*, std::size_t) {
+    return -1;
+}
+
+#endif // TODO_ZSTD
+
+CompressedText::StreamDecoder::~StreamDecoder() = default;
+
+const std::string& CompressedText::StreamDecoder::error() const {
+    return state->error;
+}
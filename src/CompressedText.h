@@ -0,0 +1,69 @@
+#ifndef COMPRESSED_TEXT_H
+#define COMPRESSED_TEXT_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "AtomicFileWriter.h"
+#include "TaskView.h"
+
+// CompressedText reads and writes the text task format compressed with zstd.
+// A file is a series of independent zstd frames, each holding about chunkSize bytes of whole lines and
+// recording how big it is decompressed. That makes it an ordinary .zst file (`zstd -d` turns it back into
+// the text format), and lets the loader find every frame up front, decompress them on separate threads
+// straight into one buffer and hand that to the regular line parser.
+// Any other .zst file is read too (single-threaded if its frames don't record their size).
+// Compression needs zstd at build time (TODO_ZSTD); without it compressed files can't be written or read,
+// but are still recognized and reported as such.
+class CompressedText {
+public:
+    static constexpr unsigned char magic[4] = {0x28, 0xb5, 0x2f, 0xfd};  // Start of every zstd frame
+    static constexpr std::size_t chunkSize = 1 << 20;                     // Text per frame
+    static constexpr int level = 1;                                       // zstd's fastest regular level
+    // Most text a zstd frame can expand to per compressed byte (a 128 KiB run in a 4-byte block);
+    // frames whose header declares more are rejected before anything is allocated for them
+    static constexpr std::size_t maxRatio = 32768;
+
+    // True if this build can read and write compressed files
+    static bool available();
+
+    // True if the bytes start with a zstd frame
+    static bool isCompressed(std::string_view contents);
+
+    // True if the path ends in ".zst" (such files are written compressed by default)
+    static bool hasCompressedExtension(std::string_view path);
+
+    // Formats the tasks as text and writes them as frames through the writer (the caller commits it);
+    // chunks are compressed on up to threadCount threads at a time (0 = one per core)
+    static bool write(AtomicFileWriter& writer, const TaskView& tasks, unsigned threadCount = 0);
+
+    // Decompresses every frame into text, on up to threadCount threads (0 = one per core);
+    // on failure returns false and sets error
+    static bool decompress(std::string_view contents, std::string& text, unsigned threadCount, std::string& error);
+
+    // Decompresses a file incrementally from a descriptor, for TaskStream: memory stays one input block
+    // plus zstd's window, however big the file is
+    class StreamDecoder {
+    private:
+        struct State;
+        std::unique_ptr<State> state;
+
+    public:
+        // Reads the rest of the stream from fd; head holds bytes already read from its start
+        StreamDecoder(int fd, std::string_view head);
+        ~StreamDecoder();
+
+        StreamDecoder(const StreamDecoder&) = delete;
+        StreamDecoder& operator=(const StreamDecoder&) = delete;
+
+        // Decompresses up to capacity bytes into out; returns how many (0 at the end) or -1 on an error
+        // (including a file cut off mid-frame), with the reason in error()
+        long read(char* out, std::size_t capacity);
+
+        const std::string& error() const;
+    };
+};
+
+#endif // COMPRESSED_TEXT_H
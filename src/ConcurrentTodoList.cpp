@@ -0,0 +1,362 @@
+#include "ConcurrentTodoList.h"
+#include <functional>   // For std::hash<std::thread::id>
+#include <limits>
+#include <thread>       // For std::this_thread
+
+// Reader loads, writer publishes and the epoch / reader slot traffic use the default seq_cst order:
+// reclamation is only safe if a reader pinning and a writer unlinking can't both miss each other.
+// (On x86 a seq_cst load costs the same as an acquire load, so readers pay nothing for it.)
+
+namespace {
+
+// Retired objects a shard collects before it checks which of them readers can still reach
+constexpr std::size_t reclaimBatch = 64;
+
+template <typename T>
+void destroy(const void* object) {
+    delete static_cast<const T*>(object);
+}
+
+// Frees a whole chunk table: its chunks and the tasks in them too
+template <typename Table>
+void destroyWithTasks(const void* object) {
+    const auto* table = static_cast<const Table*>(object);
+    for (std::size_t i = 0; i < table->capacity; i++) {
+        if (const auto* chunk = table->chunks[i].load(std::memory_order_relaxed)) {
+            for (const Task* task : *chunk) {
+                delete task;
+            }
+            delete chunk;
+        }
+    }
+    delete table;
+}
+
+} // namespace
+
+ConcurrentTodoList::ChunkTable::ChunkTable(std::size_t capacity)
+    : capacity(capacity), chunks(std::make_unique<std::atomic<const Chunk*>[]>(capacity)) {}
+
+// Constructor: every shard starts with an empty table, and IDs start at 1
+ConcurrentTodoList::ConcurrentTodoList() : nextTaskId(1) {
+    for (Shard& shard : shards) {
+        shard.table.store(new ChunkTable(0));
+        shard.reclaimAt = reclaimBatch;
+    }
+}
+
+// No snapshot can outlive the list, so everything retired can go straight away
+ConcurrentTodoList::~ConcurrentTodoList() {
+    for (Shard& shard : shards) {
+        for (const Retired& item : shard.retired) {
+            item.destroy(item.object);
+        }
+        destroyWithTasks<ChunkTable>(shard.table.load());
+    }
+}
+
+const Task* ConcurrentTodoList::findIn(const ChunkTable& table, std::size_t position) {
+    std::size_t chunk = position / chunkSize;
+    if (chunk >= table.capacity) {
+        return nullptr;
+    }
+    const Chunk* tasks = table.chunks[chunk].load();
+    return tasks ? (*tasks)[position % chunkSize] : nullptr;
+}
+
+// Each thread starts looking at its own slot, so a reader usually finds it free and its cache line local
+std::size_t ConcurrentTodoList::pin() const {
+    thread_local std::size_t hint = std::hash<std::thread::id>{}(std::this_thread::get_id()) % readerSlots;
+    while (true) {
+        std::uint64_t current = epoch.load();
+        for (std::size_t i = 0; i < readerSlots; i++) {
+            std::size_t slot = (hint + i) % readerSlots;
+            std::uint64_t free = 0;
+            if (readers[slot].epoch.load(std::memory_order_relaxed) == 0 &&
+                readers[slot].epoch.compare_exchange_strong(free, current)) {
+                hint = slot;
+                return slot;
+            }
+        }
+        std::this_thread::yield(); // Every slot is pinned: wait for a snapshot to go away
+    }
+}
+
+void ConcurrentTodoList::unpin(std::size_t slot) const {
+    readers[slot].epoch.store(0, std::memory_order_release);
+}
+
+// Tagged with the epoch at unlink time: a reader pinned later can't have seen the object
+void ConcurrentTodoList::retire(Shard& shard, const void* object, void (*destroy)(const void*)) {
+    shard.retired.push_back({epoch.load(), object, destroy});
+    if (shard.retired.size() >= shard.reclaimAt) {
+        reclaim(shard);
+    }
+}
+
+void ConcurrentTodoList::reclaim(Shard& shard) {
+    // Readers pinning from here on get a later epoch than anything retired so far
+    epoch.fetch_add(1);
+    std::uint64_t oldestPinned = std::numeric_limits<std::uint64_t>::max();
+    for (const ReaderSlot& reader : readers) {
+        std::uint64_t pinned = reader.epoch.load();
+        if (pinned != 0) {
+            oldestPinned = std::min(oldestPinned, pinned);
+        }
+    }
+
+    std::size_t kept = 0;
+    for (const Retired& item : shard.retired) {
+        if (item.epoch < oldestPinned) {
+            item.destroy(item.object);
+        } else {
+            shard.retired[kept++] = item;
+        }
+    }
+    shard.retired.resize(kept);
+
+    // A long-lived snapshot holds everything back; don't rescan the readers on every write meanwhile
+    shard.reclaimAt = std::max(reclaimBatch, kept * 2);
+}
+
+// Copy-on-write: readers holding the old chunk keep seeing it whole until they let go of it
+void ConcurrentTodoList::replaceTask(Shard& shard, int id, std::unique_ptr<const Task> task) {
+    std::size_t position = positionOf(id);
+    std::size_t chunkIndex = position / chunkSize;
+    ChunkTable* table = shard.table.load(std::memory_order_relaxed);
+    if (chunkIndex >= table->capacity) {
+        // Doubling keeps table copies amortized O(1) per task
+        auto grown = std::make_unique<ChunkTable>(std::max(chunkIndex + 1, table->capacity * 2));
+        for (std::size_t i = 0; i < table->capacity; i++) {
+            grown->chunks[i].store(table->chunks[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        ChunkTable* outgrown = table;
+        table = grown.release();
+        shard.table.store(table);
+        retire(shard, outgrown, destroy<ChunkTable>); // Only the table: its chunks live on in the new one
+    }
+
+    const Chunk* current = table->chunks[chunkIndex].load(std::memory_order_relaxed);
+    auto next = current ? std::make_unique<Chunk>(*current) : std::make_unique<Chunk>();
+    const Task*& entry = (*next)[position % chunkSize];
+    const Task* replaced = entry;
+    if (replaced) {
+        shard.liveCount.fetch_sub(1, std::memory_order_relaxed);
+        if (replaced->isCompleted()) shard.completedCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+    if (task) {
+        shard.liveCount.fetch_add(1, std::memory_order_relaxed);
+        if (task->isCompleted()) shard.completedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    entry = task.release();
+
+    // A chunk whose last task was removed is dropped, so readers skip it without looking inside
+    bool empty = std::all_of(next->begin(), next->end(), [](const Task* slot) { return !slot; });
+    table->chunks[chunkIndex].store(empty ? nullptr : next.release());
+    if (current) {
+        retire(shard, current, destroy<Chunk>);
+    }
+    if (replaced) {
+        retire(shard, replaced, destroy<Task>);
+    }
+}
+
+void ConcurrentTodoList::reserveIdsThrough(int id) {
+    int expected = nextTaskId.load(std::memory_order_relaxed);
+    while (id >= expected && !nextTaskId.compare_exchange_weak(expected, id + 1, std::memory_order_relaxed)) {
+    }
+}
+
+// The ID is claimed before any lock is taken, so only adds landing in the same shard ever contend.
+// A clear can restart the counter between the claim and the lock; if the ID is taken by then, claim another.
+int ConcurrentTodoList::addTask(const std::string& description) {
+    auto task = std::make_unique<Task>(nextTaskId.fetch_add(1, std::memory_order_relaxed), description);
+    while (true) {
+        int id = task->getId();
+        Shard& shard = shards[shardOf(id)];
+        {
+            std::lock_guard<std::mutex> lock(shard.writeMutex);
+            if (!findIn(*shard.table.load(std::memory_order_relaxed), positionOf(id))) {
+                replaceTask(shard, id, std::move(task));
+                return id;
+            }
+        }
+        task->setId(nextTaskId.fetch_add(1, std::memory_order_relaxed));
+    }
+}
+
+bool ConcurrentTodoList::markTaskAsCompleted(int id) {
+    if (id <= 0) {
+        return false;
+    }
+
+    Shard& shard = shards[shardOf(id)];
+    std::lock_guard<std::mutex> lock(shard.writeMutex);
+    const Task* existing = findIn(*shard.table.load(std::memory_order_relaxed), positionOf(id));
+    if (!existing) {
+        return false;
+    }
+
+    // Tasks are immutable once published, so complete a copy
+    auto completed = std::make_unique<Task>(*existing);
+    completed->markAsCompleted();
+    replaceTask(shard, id, std::move(completed));
+    return true;
+}
+
+bool ConcurrentTodoList::removeTask(int id) {
+    if (id <= 0) {
+        return false;
+    }
+
+    Shard& shard = shards[shardOf(id)];
+    std::lock_guard<std::mutex> lock(shard.writeMutex);
+    if (!findIn(*shard.table.load(std::memory_order_relaxed), positionOf(id))) {
+        return false;
+    }
+    replaceTask(shard, id, nullptr);
+    return true;
+}
+
+void ConcurrentTodoList::upsertTask(const Task& task) {
+    int id = task.getId();
+    if (id <= 0) {
+        return;
+    }
+    reserveIdsThrough(id);
+
+    auto copy = std::make_unique<const Task>(task);
+    Shard& shard = shards[shardOf(id)];
+    std::lock_guard<std::mutex> lock(shard.writeMutex);
+    replaceTask(shard, id, std::move(copy));
+}
+
+std::optional<Task> ConcurrentTodoList::getTaskById(int id) const {
+    Snapshot pinned(*this);
+    if (const Task* task = pinned.find(id)) {
+        return *task;
+    }
+    return std::nullopt;
+}
+
+ConcurrentTodoList::Snapshot ConcurrentTodoList::snapshot() const {
+    return Snapshot(*this);
+}
+
+int ConcurrentTodoList::getTaskCount() const {
+    return static_cast<int>(snapshot().size());
+}
+
+int ConcurrentTodoList::getCompletedCount() const {
+    return static_cast<int>(snapshot().completedCount());
+}
+
+int ConcurrentTodoList::getPendingCount() const {
+    return static_cast<int>(snapshot().pendingCount());
+}
+
+// Builds every shard's table off to the side, then publishes them all while holding every shard lock
+void ConcurrentTodoList::setTasks(const std::vector<Task>& tasks) {
+    std::array<std::size_t, shardCount> chunkCounts{};
+    for (const Task& task : tasks) {
+        if (task.getId() > 0) {
+            std::size_t& count = chunkCounts[shardOf(task.getId())];
+            count = std::max(count, positionOf(task.getId()) / chunkSize + 1);
+        }
+    }
+
+    std::array<std::unique_ptr<ChunkTable>, shardCount> tables;
+    std::array<std::size_t, shardCount> liveCounts{}, completedCounts{};
+    for (std::size_t i = 0; i < shardCount; i++) {
+        tables[i] = std::make_unique<ChunkTable>(chunkCounts[i]);
+    }
+
+    int maxId = 0;
+    try {
+        for (const Task& task : tasks) {
+            int id = task.getId();
+            if (id <= 0) {
+                continue;
+            }
+
+            // Nothing else can see these chunks yet, so filling them in place is safe
+            std::size_t shard = shardOf(id);
+            std::size_t position = positionOf(id);
+            auto& slot = tables[shard]->chunks[position / chunkSize];
+            auto* chunk = const_cast<Chunk*>(slot.load(std::memory_order_relaxed));
+            if (!chunk) {
+                chunk = new Chunk{};
+                slot.store(chunk, std::memory_order_relaxed);
+            }
+            const Task*& entry = (*chunk)[position % chunkSize];
+            if (entry) {
+                continue; // Only the first task with a given ID is kept, as in TodoList
+            }
+            entry = new Task(task);
+            liveCounts[shard]++;
+            if (task.isCompleted()) completedCounts[shard]++;
+            maxId = std::max(maxId, id);
+        }
+    } catch (...) {
+        for (auto& table : tables) {
+            destroyWithTasks<ChunkTable>(table.release());
+        }
+        throw;
+    }
+
+    std::array<std::unique_lock<std::mutex>, shardCount> locks;
+    for (std::size_t i = 0; i < shardCount; i++) {
+        locks[i] = std::unique_lock<std::mutex>(shards[i].writeMutex);
+    }
+    for (std::size_t i = 0; i < shardCount; i++) {
+        Shard& shard = shards[i];
+        ChunkTable* replaced = shard.table.exchange(tables[i].release());
+        shard.liveCount.store(liveCounts[i], std::memory_order_relaxed);
+        shard.completedCount.store(completedCounts[i], std::memory_order_relaxed);
+        retire(shard, replaced, destroyWithTasks<ChunkTable>);
+    }
+    nextTaskId.store(maxId + 1, std::memory_order_relaxed);
+}
+
+void ConcurrentTodoList::clearAllTasks() {
+    setTasks({});
+}
+
+// Snapshot queries: everything below reads published, immutable chunks only
+
+ConcurrentTodoList::Snapshot::Snapshot(const ConcurrentTodoList& list) : list(list), slot(list.pin()) {}
+
+ConcurrentTodoList::Snapshot::~Snapshot() {
+    list.unpin(slot);
+}
+
+std::size_t ConcurrentTodoList::Snapshot::size() const {
+    std::size_t total = 0;
+    for (const Shard& shard : list.shards) total += shard.liveCount.load(std::memory_order_relaxed);
+    return total;
+}
+
+std::size_t ConcurrentTodoList::Snapshot::completedCount() const {
+    std::size_t total = 0;
+    for (const Shard& shard : list.shards) total += shard.completedCount.load(std::memory_order_relaxed);
+    return total;
+}
+
+std::size_t ConcurrentTodoList::Snapshot::pendingCount() const {
+    return size() - completedCount();
+}
+
+const Task* ConcurrentTodoList::Snapshot::find(int id) const {
+    if (id <= 0) {
+        return nullptr;
+    }
+    return findIn(*list.shards[shardOf(id)].table.load(), positionOf(id));
+}
+
+std::vector<Task> ConcurrentTodoList::Snapshot::tasks(TaskView::Filter filter) const {
+    std::vector<Task> result;
+    result.reserve(filter == TaskView::Filter::All ? size()
+                   : filter == TaskView::Filter::Completed ? completedCount() : pendingCount());
+    forEach([&result](const Task& task) { result.push_back(task); }, filter);
+    return result;
+}
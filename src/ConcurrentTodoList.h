@@ -0,0 +1,199 @@
+#ifndef CONCURRENT_TODOLIST_H
+#define CONCURRENT_TODOLIST_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Task.h"
+#include "TaskView.h"
+
+// ConcurrentTodoList is a thread-safe counterpart to TodoList for many writers and many readers.
+//  - IDs come from an atomic counter, so adds on different threads never wait for each other to number.
+//    An add whose ID turns out to be taken (a clear reset the counter under it) just draws another one.
+//  - Tasks are sharded by ID (id % shardCount). A mutation locks only its own shard's mutex.
+//  - Readers never lock and never touch a reference count: a Snapshot pins the current epoch in a reader
+//    slot, then follows plain pointers. Writers publish with atomic pointer stores and never wait for
+//    readers; what they replace is retired and freed once no pinned reader can still be looking at it
+//    (epoch-based reclamation).
+// Inside a shard, task k sits at position k / shardCount, in chunks of chunkSize task pointers. A mutation
+// copies only the chunk it touches (pointers, never Tasks) and swaps it into the shard's chunk table; the
+// table itself is only copied when the shard outgrows it.
+// A Snapshot sees every chunk whole, but chunks written after it was taken may show either version.
+// There are no observers and no tombstones: removed positions simply hold a null pointer.
+class ConcurrentTodoList {
+public:
+    static constexpr std::size_t shardCount = 16;
+    static constexpr std::size_t chunkSize = 64;
+    static constexpr std::size_t readerSlots = 128;  // Snapshots alive at once before new ones have to wait
+
+private:
+    using Chunk = std::array<const Task*, chunkSize>; // Immutable once published; nullptr = no task
+
+    // A shard's chunks; nullptr for a chunk with no tasks in it
+    struct ChunkTable {
+        std::size_t capacity;
+        std::unique_ptr<std::atomic<const Chunk*>[]> chunks;
+
+        explicit ChunkTable(std::size_t capacity);
+    };
+
+    // Something a writer unlinked, waiting until no reader pinned at or before epoch is left
+    struct Retired {
+        std::uint64_t epoch;
+        const void* object;
+        void (*destroy)(const void*);
+    };
+
+    struct alignas(64) Shard {                       // Own cache line, so shards don't false-share
+        std::mutex writeMutex;                       // Serializes writers of this shard
+        std::atomic<ChunkTable*> table;              // What readers see
+        std::atomic<std::size_t> liveCount{0};       // Tasks stored in this shard
+        std::atomic<std::size_t> completedCount{0};  // How many of them are completed
+        std::vector<Retired> retired;                // Guarded by writeMutex
+        std::size_t reclaimAt = 0;                   // Retired list size that triggers the next reclaim
+    };
+
+    struct alignas(64) ReaderSlot {
+        std::atomic<std::uint64_t> epoch{0};         // Epoch the reader pinned, 0 if the slot is free
+    };
+
+    std::array<Shard, shardCount> shards;
+    mutable std::array<ReaderSlot, readerSlots> readers;
+    std::atomic<std::uint64_t> epoch{1};             // Advanced by writers whenever they reclaim
+    std::atomic<int> nextTaskId;                     // Next ID handed out by addTask
+
+    static std::size_t shardOf(int id) { return static_cast<std::size_t>(id) % shardCount; }
+    static std::size_t positionOf(int id) { return static_cast<std::size_t>(id) / shardCount; }
+
+    // The task at a position of a shard's table (nullptr if absent)
+    static const Task* findIn(const ChunkTable& table, std::size_t position);
+
+    // Claims a reader slot pinned at the current epoch / frees it again
+    std::size_t pin() const;
+    void unpin(std::size_t slot) const;
+
+    // Hands an unlinked object to the shard's retired list and frees whatever no reader can reach anymore.
+    // The caller holds the shard's writeMutex.
+    void retire(Shard& shard, const void* object, void (*destroy)(const void*));
+    void reclaim(Shard& shard);
+
+    // Publishes a copy of the chunk holding id's position with the task replaced (nullptr removes it).
+    // The caller holds the shard's writeMutex.
+    void replaceTask(Shard& shard, int id, std::unique_ptr<const Task> task);
+
+    // Raises nextTaskId past id if needed
+    void reserveIdsThrough(int id);
+
+public:
+    // Snapshot is a lock-free read view of the list. While it is alive, every task reached through it stays
+    // valid and unchanged, whatever writers do meanwhile (they retire, but can't free, what it might see).
+    // Hold one only as long as the reading takes: memory retired meanwhile is freed only after it goes away.
+    class Snapshot {
+    private:
+        const ConcurrentTodoList& list;
+        std::size_t slot;   // Reader slot holding the pin
+
+        explicit Snapshot(const ConcurrentTodoList& list);
+        friend class ConcurrentTodoList;
+
+    public:
+        ~Snapshot();
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        // Number of tasks, and how many are completed / pending (as of the call)
+        std::size_t size() const;
+        std::size_t completedCount() const;
+        std::size_t pendingCount() const;
+
+        // The task with this ID, or nullptr (valid while the snapshot lives)
+        const Task* find(int id) const;
+
+        // Calls visit(const Task&) on every task that passes the filter, in ID order
+        template <typename Visitor>
+        void forEach(Visitor&& visit, TaskView::Filter filter = TaskView::Filter::All) const;
+
+        // Copies the tasks that pass the filter, in ID order
+        std::vector<Task> tasks(TaskView::Filter filter = TaskView::Filter::All) const;
+    };
+
+    ConcurrentTodoList();
+    ~ConcurrentTodoList();
+
+    ConcurrentTodoList(const ConcurrentTodoList&) = delete;
+    ConcurrentTodoList& operator=(const ConcurrentTodoList&) = delete;
+
+    // Adds a new pending task and returns its ID
+    int addTask(const std::string& description);
+
+    // Marks a task as completed by ID; returns true if it exists and was updated
+    bool markTaskAsCompleted(int id);
+
+    // Removes a task by ID; returns true if successful
+    bool removeTask(int id);
+
+    // Stores a task exactly as given, replacing any task with the same ID (bumps the ID counter past it)
+    void upsertTask(const Task& task);
+
+    // Returns a copy of the task with this ID, if there is one (no raw pointers that a writer could invalidate)
+    std::optional<Task> getTaskById(int id) const;
+
+    // Takes a lock-free snapshot of the whole list
+    Snapshot snapshot() const;
+
+    // Convenience counts (each takes a snapshot)
+    int getTaskCount() const;
+    int getCompletedCount() const;
+    int getPendingCount() const;
+
+    // setTasks replaces every task (non-positive or duplicate IDs are skipped); clearAllTasks empties the
+    // list and restarts IDs at 1. Both lock every shard, so they wait for in-flight writers; readers are never blocked.
+    // An add racing with either may land before or after it, but never on top of another task.
+    void setTasks(const std::vector<Task>& tasks);
+    void clearAllTasks();
+};
+
+template <typename Visitor>
+void ConcurrentTodoList::Snapshot::forEach(Visitor&& visit, TaskView::Filter filter) const {
+    // ID order is position-major: id = position * shardCount + shard
+    std::array<const ChunkTable*, shardCount> tables;
+    std::size_t chunkCount = 0;
+    for (std::size_t shard = 0; shard < shardCount; shard++) {
+        tables[shard] = list.shards[shard].table.load();
+        chunkCount = std::max(chunkCount, tables[shard]->capacity);
+    }
+
+    for (std::size_t chunk = 0; chunk < chunkCount; chunk++) {
+        // Gather this chunk index from every shard; emptied chunks are null, so gaps cost almost nothing
+        std::array<const Chunk*, shardCount> row{};
+        bool anyTasks = false;
+        for (std::size_t shard = 0; shard < shardCount; shard++) {
+            if (chunk < tables[shard]->capacity) {
+                row[shard] = tables[shard]->chunks[chunk].load();
+                anyTasks = anyTasks || row[shard];
+            }
+        }
+        if (!anyTasks) continue;
+
+        for (std::size_t offset = 0; offset < chunkSize; offset++) {
+            for (const Chunk* tasks : row) {
+                if (!tasks) continue;
+                const Task* task = (*tasks)[offset];
+                if (!task) continue;
+                if (filter == TaskView::Filter::Completed && !task->isCompleted()) continue;
+                if (filter == TaskView::Filter::Pending && task->isCompleted()) continue;
+                visit(*task);
+            }
+        }
+    }
+}
+
+#endif // CONCURRENT_TODOLIST_H
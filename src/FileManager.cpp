@@ -3,15 +3,157 @@
 #include <iostream>     // For console output (cerr, cout)
 #include <filesystem>   // For filesystem operations like checking and creating directories
 #include <stdexcept>    // For exception handling (std::runtime_error, std::invalid_argument, etc.)
+#include <algorithm>    // For std::count when sizing chunks
+#include <cstring>      // For memchr when finding line boundaries
+#include <exception>    // For std::exception_ptr (errors raised on worker threads)
+#include <iterator>     // For std::back_inserter when merging chunks
+#include <thread>       // For the parser threads used by loadTasksParallel
+#include <sys/stat.h>   // For stat when checking the file is the one last saved
+#include "MappedFile.h"
+#include "BinarySnapshot.h"
+#include "CompressedText.h"
+#include "Metrics.h"
+
+namespace {
+
+// Everything one parser thread produces for its chunk of the file
+// (Item is Task, or TaskRecord when the descriptions can stay in the mapped file)
+template <typename Item>
+struct ChunkResult {
+    std::vector<Item> items;            // Parsed lines, in file order
+    std::vector<std::string> warnings;  // Messages for malformed lines, in file order
+    std::exception_ptr error;           // Set if the thread failed outright (e.g. out of memory)
+};
+
+TaskParseError parseLine(std::string_view line, Task& task) { return Task::parse(line, task); }
+TaskParseError parseLine(std::string_view line, TaskRecord& record) { return parseTaskRecord(line, record); }
+
+// Parses every line of a newline-aligned chunk; each item is parsed in place at the end of the vector
+template <typename Item>
+void parseChunk(std::string_view chunk, ChunkResult<Item>& result) {
+    try {
+        result.items.reserve(std::count(chunk.begin(), chunk.end(), '\n') + 1);
+
+        while (!chunk.empty()) {
+            const void* newline = std::memchr(chunk.data(), '\n', chunk.size());
+            std::size_t length = newline ? static_cast<const char*>(newline) - chunk.data() : chunk.size();
+            std::string_view line = chunk.substr(0, length);
+            chunk.remove_prefix(newline ? length + 1 : length);
+
+            if (line.empty()) {
+                continue;
+            }
+
+            Item& item = result.items.emplace_back();
+            TaskParseError error = parseLine(line, item);
+            if (error != TaskParseError::None) {
+                result.items.pop_back();
+                result.warnings.push_back("Error parsing task: " + std::string(describeParseError(error)) +
+                                          ": " + std::string(line));
+            }
+        }
+    } catch (...) {
+        result.error = std::current_exception();
+    }
+}
+
+// Splits the text into newline-aligned chunks, parses them on threadCount threads (0 = one per core),
+// prints the warnings and returns every item in file order
+template <typename Item>
+std::vector<Item> parseTextParallel(std::string_view contents, unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Cut the file into roughly equal chunks, moving each cut forward to just after a newline
+    std::vector<std::size_t> bounds = {0};
+    for (unsigned i = 1; i < threadCount; i++) {
+        std::size_t cut = contents.size() / threadCount * i;
+        if (cut <= bounds.back()) {
+            continue;
+        }
+        const void* newline = std::memchr(contents.data() + cut, '\n', contents.size() - cut);
+        if (!newline) {
+            break;
+        }
+        bounds.push_back(static_cast<const char*>(newline) - contents.data() + 1);
+    }
+    bounds.push_back(contents.size());
+
+    // One thread per chunk; the first chunk is parsed on this thread
+    std::size_t chunkCount = bounds.size() - 1;
+    std::vector<ChunkResult<Item>> results(chunkCount);
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < chunkCount; i++) {
+        workers.emplace_back(parseChunk<Item>, contents.substr(bounds[i], bounds[i + 1] - bounds[i]),
+                             std::ref(results[i]));
+    }
+    parseChunk(contents.substr(0, bounds[1]), results[0]);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Merge in file order, moving items rather than copying them
+    std::size_t total = 0;
+    std::size_t malformed = 0;
+    for (const auto& result : results) {
+        if (result.error) {
+            std::rethrow_exception(result.error);
+        }
+        total += result.items.size();
+        malformed += result.warnings.size();
+    }
+    TODO_METRICS_COUNT(ParsedBytes, contents.size());
+    TODO_METRICS_COUNT(ParsedLines, total + malformed);
+    TODO_METRICS_COUNT(MalformedLines, malformed);
+    if (chunkCount == 1) {
+        for (const auto& warning : results[0].warnings) {
+            std::cerr << warning << std::endl;
+            std::cerr << "Skipping malformed task entry." << std::endl;
+        }
+        return std::move(results[0].items);
+    }
+
+    std::vector<Item> items;
+    items.reserve(total);
+    for (auto& result : results) {
+        for (const auto& warning : result.warnings) {
+            std::cerr << warning << std::endl;
+            std::cerr << "Skipping malformed task entry." << std::endl;
+        }
+        std::move(result.items.begin(), result.items.end(), std::back_inserter(items));
+    }
+    return items;
+}
+
+// Compressed files are decompressed (on threadCount threads) into text, and contents is pointed at it, so they
+// parse like any text file. False, with the reason printed, if the file couldn't be decompressed.
+bool expandCompressed(std::string_view& contents, std::string& text, unsigned threadCount) {
+    if (!CompressedText::isCompressed(contents)) {
+        return true;
+    }
+    std::string error;
+    if (!CompressedText::decompress(contents, text, threadCount, error)) {
+        std::cerr << "Error loading tasks: " << error << std::endl;
+        return false;
+    }
+    contents = text;
+    return true;
+}
+
+} // namespace
 
 // Constructor
-FileManager::FileManager(const std::string& filePath) : filePath(filePath) {
+FileManager::FileManager(const std::string& filePath)
+    : filePath(filePath), fsyncPolicy(FsyncPolicy::Always), unsyncedSave(false),
+      saveFormat(CompressedText::hasCompressedExtension(filePath) ? FileFormat::Compressed : FileFormat::Text),
+      incrementalSaves(false) {
     try {
-        // Attempt to ensure the "data" directory exists before using the file
-        std::string dirPath = "data";
-        if (!std::filesystem::exists(dirPath)) {
+        // Attempt to ensure the file's directory (e.g. "data") exists before using the file
+        std::filesystem::path dirPath = std::filesystem::path(filePath).parent_path();
+        if (!dirPath.empty() && !std::filesystem::exists(dirPath)) {
             // If not, create it
-            std::filesystem::create_directory(dirPath);
+            std::filesystem::create_directories(dirPath);
         }
     } catch (const std::filesystem::filesystem_error& e) {
         // Catch and report any filesystem-specific errors
@@ -24,37 +166,83 @@ FileManager::FileManager(const std::string& filePath) : filePath(filePath) {
     }
 }
 
+// Destructor: with the OnExit policy this is where the last save finally reaches the disk
+FileManager::~FileManager() {
+    if (fsyncPolicy == FsyncPolicy::OnExit && unsyncedSave) {
+        if (!AtomicFileWriter::syncFile(filePath)) {
+            std::cerr << "Warning: Failed to sync " << filePath << " to disk." << std::endl;
+        }
+    }
+}
+
+void FileManager::setFsyncPolicy(FsyncPolicy policy) {
+    fsyncPolicy = policy;
+}
+
+void FileManager::setSaveFormat(FileFormat format) {
+    saveFormat = format;
+}
+
+void FileManager::setIncrementalSaves(bool enabled) {
+    incrementalSaves = enabled;
+}
+
 // Methods
 bool FileManager::saveTasks(const std::vector<Task>& tasks) {
+    return saveTasks(TaskView(tasks));
+}
+
+bool FileManager::saveTasks(const TaskView& tasks) {
+    TODO_METRICS_TIME(Save);
     try {
-        // Open the file for writing (overwrites existing content)
-        std::ofstream file(filePath);
+        // Write to a temporary file first; the live file is only replaced once everything is on disk
+        AtomicFileWriter writer(filePath, writeBuffer);
 
-        if (!file.is_open()) {
+        if (!writer.good()) {
             // If opening fails, print an error and return false
             std::cerr << "Error: Could not open file for writing: " << filePath << std::endl;
             return false;
         }
 
-        // Write each task as a line in the file
-        for (const auto& task : tasks) {
-            file << task.toString() << std::endl;
-
-            // Check if writing failed at any point
-            if (file.fail()) {
-                std::cerr << "Error: Failed to write task to file." << std::endl;
-                file.close();
+        if (saveFormat == FileFormat::Binary) {
+            // Binary snapshots are written column by column
+            if (!BinarySnapshot::write(writer, tasks)) {
+                std::cerr << "Error: Failed to write binary snapshot." << std::endl;
+                return false;
+            }
+        } else if (saveFormat == FileFormat::Compressed) {
+            // Text lines, compressed a chunk at a time
+            if (!CompressedText::available()) {
+                std::cerr << "Error: This build can't write compressed task files (no zstd support)." << std::endl;
                 return false;
             }
+            if (!CompressedText::write(writer, tasks)) {
+                std::cerr << "Error: Failed to write compressed tasks." << std::endl;
+                return false;
+            }
+        } else {
+            // Format each task into the shared buffer; it is written out in large blocks
+            std::string& out = writer.output();
+            for (const auto& task : tasks) {
+                task.appendTo(out);
+                out += '\n';
+
+                // Check if writing failed at any point
+                if (!writer.flushIfFull()) {
+                    std::cerr << "Error: Failed to write task to file." << std::endl;
+                    return false;
+                }
+            }
         }
 
-        // Close the file after writing
-        file.close();
-        // Check if the close operation failed
-        if (file.fail()) {
-            std::cerr << "Error: Failed to close the file properly." << std::endl;
+        // Flush, fsync if the policy asks for it, and atomically swap the new file in
+        bool sync = fsyncPolicy == FsyncPolicy::Always;
+        if (!writer.commit(sync)) {
+            std::cerr << "Error: Failed to write and replace the file properly." << std::endl;
             return false;
         }
+        unsyncedSave = !sync;
+        TODO_METRICS_COUNT(SavedTasks, tasks.size());
 
         return true;
     } catch (const std::exception& e) {
@@ -64,7 +252,115 @@ bool FileManager::saveTasks(const std::vector<Task>& tasks) {
     }
 }
 
+bool FileManager::stampLayout() {
+    struct stat info;
+    if (stat(filePath.c_str(), &info) != 0) {
+        return false;
+    }
+    layout.device = static_cast<std::uint64_t>(info.st_dev);
+    layout.inode = static_cast<std::uint64_t>(info.st_ino);
+    layout.size = static_cast<std::uint64_t>(info.st_size);
+    layout.modified = static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+    return true;
+}
+
+bool FileManager::layoutMatchesFile() const {
+    struct stat info;
+    return layout.checkpoint != 0 && stat(filePath.c_str(), &info) == 0 &&
+           static_cast<std::uint64_t>(info.st_dev) == layout.device &&
+           static_cast<std::uint64_t>(info.st_ino) == layout.inode &&
+           static_cast<std::uint64_t>(info.st_size) == layout.size &&
+           static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec == layout.modified;
+}
+
+// Tombstone slots have no line, but still get an offset if they start a block
+template <typename Writer>
+bool FileManager::writeSlots(Writer& writer, std::span<const Task> slots, std::size_t firstSlot,
+                             std::uint64_t offset) {
+    layout.blockOffsets.resize(firstSlot / layoutBlock);
+    std::string& out = writer.output();
+    for (std::size_t slot = firstSlot; slot < slots.size(); slot++) {
+        if (slot % layoutBlock == 0) {
+            layout.blockOffsets.push_back(offset);
+        }
+        const Task& task = slots[slot];
+        if (task.getId() == 0) {
+            continue;
+        }
+
+        std::size_t before = out.size();
+        task.appendTo(out);
+        out += '\n';
+        offset += out.size() - before;
+        if (!writer.flushIfFull()) {
+            return false;
+        }
+    }
+    if (slots.size() % layoutBlock == 0) {
+        layout.blockOffsets.push_back(offset);  // So a later append can start right at the end
+    }
+    layout.slotCount = slots.size();
+    return true;
+}
+
+bool FileManager::saveTasks(TodoList& list) {
+    if (saveFormat != FileFormat::Text) {
+        layout.checkpoint = 0;
+        return saveTasks(list.viewAllTasks());
+    }
+
+    TODO_METRICS_TIME(Save);
+    std::span<const Task> slots = list.getSlots();
+    bool sync = fsyncPolicy == FsyncPolicy::Always;
+    std::size_t firstChanged = 0;  // Slot to start rewriting from (0 = rewrite the whole file)
+    if (incrementalSaves && layoutMatchesFile()) {
+        firstChanged = list.firstSlotChangedSince(layout.checkpoint);
+    }
+    try {
+        if (firstChanged > 0) {
+            if (firstChanged == slots.size() && slots.size() == layout.slotCount) {
+                return true;  // The file already holds exactly this list
+            }
+
+            // Rewrite in place from the start of the changed slot's block; lines before it stay as they are
+            std::size_t firstSlot = firstChanged / layoutBlock * layoutBlock;
+            std::uint64_t offset = layout.blockOffsets[firstSlot / layoutBlock];
+            TailFileWriter writer(filePath, offset, writeBuffer);
+            layout.checkpoint = 0;  // Whatever happens next, the old layout no longer describes the file
+            if (!writer.good() || !writeSlots(writer, slots, firstSlot, offset) || !writer.commit(sync)) {
+                std::cerr << "Error: Failed to rewrite the end of " << filePath << std::endl;
+                return false;
+            }
+            TODO_METRICS_COUNT(SavedTasks, slots.size() - firstSlot);
+        } else {
+            // Nothing to build on: write the whole file atomically, recording the layout on the way
+            AtomicFileWriter writer(filePath, writeBuffer);
+            layout.checkpoint = 0;
+            if (!writer.good()) {
+                std::cerr << "Error: Could not open file for writing: " << filePath << std::endl;
+                return false;
+            }
+            if (!writeSlots(writer, slots, 0, 0) || !writer.commit(sync)) {
+                std::cerr << "Error: Failed to write and replace the file properly." << std::endl;
+                return false;
+            }
+            TODO_METRICS_COUNT(SavedTasks, list.getTaskCount());
+        }
+        unsyncedSave = !sync;
+
+        // The next save builds on this one, as long as nobody else touches the file meanwhile
+        if (stampLayout()) {
+            layout.checkpoint = list.markCheckpoint();
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error saving tasks: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 std::vector<Task> FileManager::loadTasks() {
+    TODO_METRICS_TIME(Load);
     std::vector<Task> tasks;
 
     try {
@@ -83,21 +379,43 @@ std::vector<Task> FileManager::loadTasks() {
             return tasks;
         }
 
+        // Binary snapshots and compressed files start with a magic number; anything else is read as text
+        char head[sizeof(BinarySnapshot::magic)];
+        file.read(head, sizeof(head));
+        if (BinarySnapshot::isBinarySnapshot(std::string_view(head, file.gcount()))) {
+            file.close();
+            return loadBinaryTasks();
+        }
+        if (CompressedText::isCompressed(std::string_view(head, file.gcount()))) {
+            file.close();
+            return loadCompressedTasks();
+        }
+        file.clear();
+        file.seekg(0);
+
         std::string line;
+        Task task;
+        std::size_t bytes = 0, lines = 0, malformed = 0;
         // Read the file line by line
         while (std::getline(file, line)) {
+            bytes += line.size() + 1;
             if (!line.empty()) {
-                try {
-                    // Attempt to parse each line into a Task object
-                    Task task = Task::fromString(line);
+                lines++;
+                // Attempt to parse each line into a Task object
+                TaskParseError error = Task::parse(line, task);
+                if (error == TaskParseError::None) {
                     tasks.push_back(task);
-                } catch (const std::exception& e) {
+                } else {
                     // If parsing fails, report the error and skip the line
-                    std::cerr << "Error parsing task: " << e.what() << std::endl;
+                    malformed++;
+                    std::cerr << "Error parsing task: " << describeParseError(error) << ": " << line << std::endl;
                     std::cerr << "Skipping malformed task entry." << std::endl;
                 }
             }
         }
+        TODO_METRICS_COUNT(ParsedBytes, bytes);
+        TODO_METRICS_COUNT(ParsedLines, lines);
+        TODO_METRICS_COUNT(MalformedLines, malformed);
 
         // Check if an error occurred while reading
         if (file.bad()) {
@@ -114,6 +432,181 @@ std::vector<Task> FileManager::loadTasks() {
     return tasks;
 }
 
+std::vector<Task> FileManager::loadTasksParallel(unsigned threadCount) {
+    TODO_METRICS_TIME(Load);
+    std::vector<Task> tasks;
+
+    try {
+        // If the file doesn't exist, notify the user and return an empty list
+        if (!fileExists()) {
+            std::cout << "Note: No existing task file found." << std::endl;
+            return tasks;
+        }
+
+        MappedFile file(filePath);
+        if (!file.isOpen()) {
+            std::cerr << "Warning: Could not open file for reading: " << filePath << std::endl;
+            return tasks;
+        }
+
+        std::string_view contents = file.contents();
+        if (BinarySnapshot::isBinarySnapshot(contents)) {
+            std::string error;
+            if (!BinarySnapshot::read(contents, tasks, error)) {
+                std::cerr << "Error loading tasks: " << error << std::endl;
+                tasks.clear();
+            }
+            return tasks;
+        }
+
+        std::string text;
+        if (!expandCompressed(contents, text, threadCount)) {
+            return tasks;
+        }
+        tasks = parseTextParallel<Task>(contents, threadCount);
+    } catch (const std::exception& e) {
+        // Catch and report any errors during the load process
+        std::cerr << "Error loading tasks: " << e.what() << std::endl;
+    }
+
+    return tasks;
+}
+
+bool FileManager::loadInto(TodoList& list, unsigned threadCount) {
+    TODO_METRICS_TIME(Load);
+    try {
+        if (!fileExists()) {
+            std::cout << "Note: No existing task file found." << std::endl;
+            return false;
+        }
+
+        MappedFile file(filePath);
+        if (!file.isOpen()) {
+            std::cerr << "Warning: Could not open file for reading: " << filePath << std::endl;
+            return false;
+        }
+
+        // Records point into the mapping (or the decompressed text), which stays alive until the list has
+        // copied them into its arena
+        std::string_view contents = file.contents();
+        std::string text;
+        std::vector<TaskRecord> records;
+        if (BinarySnapshot::isBinarySnapshot(contents)) {
+            std::string error;
+            if (!BinarySnapshot::read(contents, records, error)) {
+                std::cerr << "Error loading tasks: " << error << std::endl;
+                return false;
+            }
+        } else {
+            if (!expandCompressed(contents, text, threadCount)) {
+                return false;
+            }
+            records = parseTextParallel<TaskRecord>(contents, threadCount);
+        }
+
+        list.setTasks(records);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error loading tasks: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+std::vector<Task> FileManager::loadBinaryTasks() {
+    std::vector<Task> tasks;
+    std::string error;
+
+    MappedFile file(filePath);
+    if (!file.isOpen()) {
+        std::cerr << "Warning: Could not open file for reading: " << filePath << std::endl;
+    } else if (!BinarySnapshot::read(file.contents(), tasks, error)) {
+        std::cerr << "Error loading tasks: " << error << std::endl;
+        tasks.clear();
+    }
+
+    return tasks;
+}
+
+std::vector<Task> FileManager::loadCompressedTasks() {
+    std::vector<Task> tasks;
+
+    MappedFile file(filePath);
+    if (!file.isOpen()) {
+        std::cerr << "Warning: Could not open file for reading: " << filePath << std::endl;
+        return tasks;
+    }
+    std::string_view contents = file.contents();
+    std::string text;
+    if (expandCompressed(contents, text, 1)) {
+        tasks = parseTextParallel<Task>(contents, 1);
+    }
+
+    return tasks;
+}
+
+TaskStore FileManager::loadTaskStore() {
+    TODO_METRICS_TIME(Load);
+    TaskStore store;
+
+    try {
+        if (!fileExists()) {
+            std::cout << "Note: No existing task file found." << std::endl;
+            return store;
+        }
+
+        MappedFile file(filePath);
+        if (!file.isOpen()) {
+            std::cerr << "Warning: Could not open file for reading: " << filePath << std::endl;
+            return store;
+        }
+
+        std::string_view contents = file.contents();
+        std::string error;
+        if (BinarySnapshot::isBinarySnapshot(contents)) {
+            if (!BinarySnapshot::read(contents, store, error)) {
+                std::cerr << "Error loading tasks: " << error << std::endl;
+                store.clear();
+            }
+            return store;
+        }
+
+        std::string text;
+        if (!expandCompressed(contents, text, 0)) {
+            return store;
+        }
+
+        // Text files go straight from parsed records into the columns, with no Task objects in between
+        TODO_METRICS_COUNT(ParsedBytes, contents.size());
+        TaskRecord record;
+        std::size_t lines = 0, malformed = 0;
+        while (!contents.empty()) {
+            std::size_t length = contents.find('\n');
+            std::string_view line = contents.substr(0, length);
+            contents.remove_prefix(length == std::string_view::npos ? contents.size() : length + 1);
+
+            if (line.empty()) {
+                continue;
+            }
+            lines++;
+            TaskParseError parseError = parseTaskRecord(line, record);
+            if (parseError == TaskParseError::None) {
+                store.append(record.id, record.description, record.completed,
+                             record.creationDate, record.completionDate);
+            } else {
+                malformed++;
+                std::cerr << "Error parsing task: " << describeParseError(parseError) << ": " << line << std::endl;
+                std::cerr << "Skipping malformed task entry." << std::endl;
+            }
+        }
+        TODO_METRICS_COUNT(ParsedLines, lines);
+        TODO_METRICS_COUNT(MalformedLines, malformed);
+    } catch (const std::exception& e) {
+        std::cerr << "Error loading tasks: " << e.what() << std::endl;
+    }
+
+    return store;
+}
+
 bool FileManager::fileExists() const {
     try {
         // Check if the file exists at the given path
@@ -1,27 +1,140 @@
 #ifndef FILE_MANAGER_H
 #define FILE_MANAGER_H
 
+#include <cstdint>
+#include <iostream>
 #include <string>
 #include <vector>
 #include "Task.h"
+#include "TaskView.h"
+#include "AtomicFileWriter.h"
+#include "TaskStore.h"
+#include "TodoList.h"
+#include "TaskFilter.h"
+#include "TaskStream.h"
+
+// On-disk formats FileManager can write (reading detects the format by itself)
+enum class FileFormat {
+    Text,       // One id|description|completed|created|completed_at line per task
+    Binary,     // Versioned columnar snapshot (see BinarySnapshot.h)
+    Compressed  // The text format in independent zstd frames (see CompressedText.h)
+};
 
 // FileManager handles reading and writing tasks to a file
 class FileManager {
 private:
     std::string filePath; // Path to the tasks file
+    FsyncPolicy fsyncPolicy; // When saves are forced out to disk
+    bool unsyncedSave;       // True if a save happened that hasn't been fsynced yet (OnExit policy)
+    std::string writeBuffer; // Reused across saves so formatting doesn't allocate per task
+    FileFormat saveFormat;   // Format used by saveTasks
+    bool incrementalSaves;   // Whether saveTasks(TodoList&) may rewrite just the changed tail (opt-in)
+
+    // Where the lines of the last saveTasks(TodoList&) sit in the file, so the next one can start rewriting
+    // at the first changed slot. Only trusted while the file is exactly as that save left it.
+    struct SavedLayout {
+        std::uint64_t checkpoint = 0;              // The list's checkpoint taken by that save (0 = none)
+        std::size_t slotCount = 0;                 // Slots the list had, tombstones included
+        std::vector<std::uint64_t> blockOffsets;   // Offset of the line of slot i * layoutBlock (or the end)
+        std::uint64_t device = 0, inode = 0;       // The file that save left behind: any other save replaces
+        std::uint64_t size = 0;                    // it (new inode) or changes its size or mtime
+        std::int64_t modified = 0;                 // mtime in nanoseconds
+    };
+    static constexpr std::size_t layoutBlock = 64; // Slots per recorded offset (a tail rewrite starts <64 early)
+    SavedLayout layout;
+
+    // Fills in the file's identity fields of layout; false if it can't be stat'ed
+    bool stampLayout();
+
+    // True if layout still describes the file on disk
+    bool layoutMatchesFile() const;
+
+    // Formats slots [firstSlot, end) into writer, recording an offset every layoutBlock slots;
+    // false if a write failed
+    template <typename Writer>
+    bool writeSlots(Writer& writer, std::span<const Task> slots, std::size_t firstSlot, std::uint64_t offset);
+
+    // Loads a binary snapshot into Task objects (empty list and a warning on failure)
+    std::vector<Task> loadBinaryTasks();
+
+    // Decompresses a compressed text file and parses it into Task objects (empty list and a warning on failure)
+    std::vector<Task> loadCompressedTasks();
 
 public:
     // Constructor with a default path, makes it easy to use out-of-the-box
     FileManager(const std::string& filePath = "data/tasks.txt");
 
-    // Saves all tasks to file — returns true if successful
+    // Syncs the last save to disk if the policy is OnExit
+    ~FileManager();
+
+    // Chooses when saves are fsynced (defaults to Always)
+    void setFsyncPolicy(FsyncPolicy policy);
+
+    // Chooses the format saveTasks writes (defaults to Compressed for a ".zst" path, Text otherwise)
+    void setSaveFormat(FileFormat format);
+    FileFormat getSaveFormat() const { return saveFormat; }
+
+    // Saves all tasks to file — returns true if successful.
+    // The new contents go to a temporary file that is renamed over the old one, so a crash
+    // mid-save leaves the previous version intact.
     bool saveTasks(const std::vector<Task>& tasks);
+    bool saveTasks(const TaskView& tasks);        // Same, straight from a TodoList view (no copy)
+
+    // Saves a whole list, like saveTasks(list.viewAllTasks()). With incremental saves turned on, the text
+    // format only rewrites what changed since this FileManager last saved that list: the file is rewritten in
+    // place from the block of the lowest changed slot on (new tasks alone just get appended), so the cost
+    // follows the size of the change, not of the list. The first save, a save after the file was replaced by
+    // anyone else, and binary and compressed saves still rewrite the file atomically.
+    bool saveTasks(TodoList& list);
+
+    // Turns tail rewrites in saveTasks(TodoList&) on or off (the default). They give up the atomic-save
+    // guarantee for the tail: a crash during an in-place rewrite can leave it torn, though the lines before
+    // it are never touched.
+    void setIncrementalSaves(bool enabled);
 
-    // Loads tasks from file — returns the list (empty if file not found or unreadable)
+    // Loads tasks from file — returns the list (empty if file not found or unreadable).
+    // Text, binary and compressed files are all accepted; the latter two are recognized by their magic number.
     std::vector<Task> loadTasks();
 
+    // Same result as loadTasks, but memory-maps the file, splits it into newline-aligned chunks and
+    // parses them on threadCount threads (0 = one per core); malformed lines are still skipped with a warning.
+    // A compressed file is first decompressed frame by frame on the same threads.
+    std::vector<Task> loadTasksParallel(unsigned threadCount = 0);
+
+    // Replaces the list's tasks with the file's, building each one straight in the list's arena
+    // (lines are parsed in parallel into records, so no intermediate Task or string is allocated).
+    // Returns false, leaving the list untouched, if the file is missing or can't be read.
+    bool loadInto(TodoList& list, unsigned threadCount = 0);
+
+    // Streams a text file through visit(const TaskRecord&) in fixed-size chunks, without loading it (see
+    // TaskStream): memory stays constant however big the file is. Only records passing the filter are
+    // visited. Returns false if the file couldn't be opened or read to the end.
+    template <typename Visit>
+    bool forEachTask(const TaskFilter& filter, Visit&& visit) const;
+
+    // Loads the file straight into a columnar TaskStore (a binary snapshot loads with bulk copies)
+    TaskStore loadTaskStore();
+
     // Utility to check if the file exists
     bool fileExists() const;
+
+    // Path of the tasks file
+    const std::string& getFilePath() const { return filePath; }
 };
 
+template <typename Visit>
+bool FileManager::forEachTask(const TaskFilter& filter, Visit&& visit) const {
+    TaskStream stream(filePath, filter);
+    if (!stream.isOpen()) {
+        std::cerr << "Warning: Could not open file for reading: " << filePath << std::endl;
+        return false;
+    }
+
+    TaskRecord record;
+    while (stream.next(record)) {
+        visit(record);
+    }
+    return !stream.failed();
+}
+
 #endif // FILE_MANAGER_H
\ No newline at end of file
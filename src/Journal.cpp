@@ -0,0 +1,274 @@
+#include "Journal.h"
+#include <cerrno>       // For errno / EINTR
+#include <charconv>     // For std::to_chars / std::from_chars on task IDs
+#include <cstdio>       // For std::rename and std::remove
+#include <filesystem>   // For checking which log files exist
+#include <iostream>     // For warnings on std::cerr
+#include <fcntl.h>      // For open
+#include <unistd.h>     // For write, fdatasync and close
+#include "FileManager.h"
+#include "MappedFile.h"
+
+// Constructor: opens (or creates) the log next to the snapshot
+Journal::Journal(const std::string& snapshotPath, FsyncPolicy fsyncPolicy, FileFormat snapshotFormat)
+    : snapshotPath(snapshotPath), journalPath(snapshotPath + ".journal"),
+      rotatedPath(snapshotPath + ".journal.old"), fsyncPolicy(fsyncPolicy), snapshotFormat(snapshotFormat),
+      fd(-1), list(nullptr),
+      bytesSinceCompaction(0), compactionThreshold(64 << 20), compacting(false), lastCompactionOk(true),
+      snapshotUnreadable(false) {
+    // The log lives next to the snapshot, whose directory may not exist yet
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(snapshotPath).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    if (!openJournal()) {
+        std::cerr << "Warning: Could not open journal: " << journalPath << std::endl;
+    }
+}
+
+Journal::~Journal() {
+    waitForCompaction();
+    detach();
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool Journal::openJournal() {
+    fd = open(journalPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bytesSinceCompaction = static_cast<std::size_t>(lseek(fd, 0, SEEK_END));
+    return true;
+}
+
+bool Journal::attach(TodoList& target) {
+    detach();
+    if (snapshotUnreadable) {
+        return false;
+    }
+    list = &target;
+    list->setObserver(this);
+    return true;
+}
+
+void Journal::detach() {
+    if (list) {
+        list->setObserver(nullptr);
+        list = nullptr;
+    }
+}
+
+// Snapshot first, then the rotated log (an unfinished compaction), then the live log
+bool Journal::recover(TodoList& target, std::size_t& replayed) {
+    waitForCompaction();
+    replayed = 0;
+
+    // Replaying must not write the records a second time
+    TodoList* attached = list;
+    detach();
+
+    // Only a missing snapshot means "no tasks": the logs on top of one that can't be read aren't the whole list
+    FileManager snapshot(snapshotPath);
+    snapshotUnreadable = false;
+    if (!snapshot.fileExists()) {
+        target.clearAllTasks();
+    } else if (!snapshot.loadInto(target)) {
+        std::cerr << "Error: Could not read journal snapshot " << snapshotPath
+                  << "; leaving it and the journal untouched" << std::endl;
+        snapshotUnreadable = true;
+        return false;
+    }
+
+    replayed = replayFile(rotatedPath, target) + replayFile(journalPath, target);
+    if (attached) {
+        attach(*attached);
+    }
+    return true;
+}
+
+std::size_t Journal::replayFile(const std::string& path, TodoList& target) {
+    if (!std::filesystem::exists(path)) {
+        return 0;
+    }
+
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        std::cerr << "Warning: Could not open journal for replay: " << path << std::endl;
+        return 0;
+    }
+
+    std::string_view contents = file.contents();
+    std::size_t applied = 0;
+    Task task;
+
+    while (!contents.empty()) {
+        std::size_t length = contents.find('\n');
+        // A record without its newline was torn by a crash mid-write; it never took effect
+        if (length == std::string_view::npos) {
+            std::cerr << "Warning: Ignoring incomplete journal record at end of " << path << std::endl;
+            break;
+        }
+        std::string_view line = contents.substr(0, length);
+        contents.remove_prefix(length + 1);
+
+        bool ok = false;
+        if (line.size() > 2 && line.substr(0, 2) == "U ") {
+            ok = Task::parse(line.substr(2), task) == TaskParseError::None;
+            if (ok) target.upsertTask(task);
+        } else if (line.size() > 2 && line.substr(0, 2) == "R ") {
+            int id = 0;
+            auto [end, error] = std::from_chars(line.data() + 2, line.data() + line.size(), id);
+            ok = error == std::errc() && end == line.data() + line.size();
+            if (ok) target.removeTask(id);
+        } else if (line == "X") {
+            ok = true;
+            target.clearAllTasks();
+        }
+
+        if (ok) {
+            applied++;
+        } else {
+            std::cerr << "Warning: Skipping malformed journal record: " << line << std::endl;
+        }
+    }
+
+    return applied;
+}
+
+// One write() per record; O_APPEND keeps each record contiguous
+void Journal::appendRecord() {
+    if (fd < 0) {
+        return;
+    }
+
+    const char* data = record.data();
+    std::size_t remaining = record.size();
+    while (remaining > 0) {
+        ssize_t written = write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Warning: Failed to append to journal: " << journalPath << std::endl;
+            return;
+        }
+        data += written;
+        remaining -= static_cast<std::size_t>(written);
+    }
+
+    if (fsyncPolicy == FsyncPolicy::Always) {
+        fdatasync(fd);
+    }
+
+    bytesSinceCompaction += record.size();
+    if (compactionThreshold > 0 && bytesSinceCompaction >= compactionThreshold && !compacting) {
+        compact();
+    }
+}
+
+void Journal::onTaskAdded(const Task& task) {
+    record = "U ";
+    task.appendTo(record);
+    record += '\n';
+    appendRecord();
+}
+
+void Journal::onTaskCompleted(const Task& task) {
+    onTaskAdded(task); // A completion is just the task's new contents
+}
+
+void Journal::onTaskRemoved(int id) {
+    char digits[16];
+    record = "R ";
+    record.append(digits, std::to_chars(digits, digits + sizeof(digits), id).ptr);
+    record += '\n';
+    appendRecord();
+}
+
+void Journal::onTasksCleared() {
+    record = "X\n";
+    appendRecord();
+}
+
+// Closes the live log and moves it aside; if an older rotation is still there (a failed or
+// interrupted compaction), the live log is appended to it so no record is ever dropped
+bool Journal::rotate() {
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+
+    bool ok = true;
+    if (std::filesystem::exists(rotatedPath)) {
+        MappedFile current(journalPath);
+        int rotatedFd = open(rotatedPath.c_str(), O_WRONLY | O_APPEND);
+        if (!current.isOpen() || rotatedFd < 0) {
+            ok = false;
+        } else {
+            std::string_view contents = current.contents();
+            while (!contents.empty()) {
+                ssize_t written = write(rotatedFd, contents.data(), contents.size());
+                if (written < 0) {
+                    if (errno == EINTR) continue;
+                    ok = false;
+                    break;
+                }
+                contents.remove_prefix(static_cast<std::size_t>(written));
+            }
+            ok = ok && fsync(rotatedFd) == 0;
+        }
+        if (rotatedFd >= 0) {
+            close(rotatedFd);
+        }
+        ok = ok && std::remove(journalPath.c_str()) == 0;
+    } else {
+        ok = std::rename(journalPath.c_str(), rotatedPath.c_str()) == 0;
+    }
+
+    // Keep logging either way; on failure the records simply stay in the live log
+    openJournal();
+    return ok;
+}
+
+bool Journal::compact() {
+    if (!list || snapshotUnreadable) {
+        return false;
+    }
+    waitForCompaction();
+
+    if (!rotate()) {
+        std::cerr << "Warning: Could not rotate journal: " << journalPath << std::endl;
+        return false;
+    }
+
+    // The copy is taken here, in memory, so mutations can keep going while it is written out
+    std::vector<Task> snapshot = list->getAllTasks();
+    compacting = true;
+    compactionThread = std::thread([this, snapshot = std::move(snapshot)]() {
+        FileManager writer(snapshotPath);
+        writer.setSaveFormat(snapshotFormat);
+        writer.setFsyncPolicy(fsyncPolicy == FsyncPolicy::Never ? FsyncPolicy::Never : FsyncPolicy::Always);
+        bool ok = writer.saveTasks(snapshot);
+
+        // Only once the snapshot is safely in place can the folded-in records go
+        if (ok) {
+            std::remove(rotatedPath.c_str());
+        }
+        lastCompactionOk = ok;
+        compacting = false;
+    });
+    return true;
+}
+
+bool Journal::waitForCompaction() {
+    if (compactionThread.joinable()) {
+        compactionThread.join();
+    }
+    return lastCompactionOk;
+}
+
+void Journal::setCompactionThreshold(std::size_t bytes) {
+    compactionThreshold = bytes;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include "AtomicFileWriter.h"
+#include "FileManager.h"
+#include "TodoList.h"
+#include "TodoListObserver.h"
+
+// Journal is an append-only write-ahead log that sits next to the task file.
+// Once attached to a TodoList, every add/complete/remove/clear is appended as one small line, so
+// persisting a change costs O(1) bytes instead of rewriting the whole file. Records are:
+//   U <task line>   store this task (add or complete; same format as Task::toString)
+//   R <id>          remove the task with this ID
+//   X               clear every task
+// Startup loads the last snapshot (the normal task file) and replays the log on top of it.
+// Compaction folds the log back into a fresh snapshot: the log is rotated to "<journal>.old" and a
+// copy of the list is written out on a background thread, after which the old log is deleted.
+// Replaying always converges, even over a snapshot that already contains some of the records.
+// With the default FsyncPolicy::Never each record reaches the OS as soon as the change is made, so it survives
+// the process crashing but not the machine losing power; FsyncPolicy::Always fdatasyncs every record.
+class Journal : public TodoListObserver {
+private:
+    std::string snapshotPath;    // The regular task file the journal applies to
+    std::string journalPath;     // "<snapshot>.journal": records since the last rotation
+    std::string rotatedPath;     // "<snapshot>.journal.old": records being folded into a snapshot
+    FsyncPolicy fsyncPolicy;     // Always = fdatasync after every record
+    FileFormat snapshotFormat;   // Format compaction writes the snapshot in (recovery reads any of them)
+    int fd;                      // Append-only descriptor of journalPath (-1 if closed)
+    std::string record;          // Reused buffer for formatting one record
+    TodoList* list;              // List we're attached to (nullptr if detached)
+
+    std::size_t bytesSinceCompaction;  // Size of the current journal file
+    std::size_t compactionThreshold;   // Auto-compact once the journal grows past this (0 = never)
+    std::thread compactionThread;      // Background snapshot writer
+    std::atomic<bool> compacting;      // True while compactionThread is running
+    std::atomic<bool> lastCompactionOk;// Result of the most recent finished compaction
+    bool snapshotUnreadable;           // recover found a snapshot it couldn't load: never attach or overwrite it
+
+    // Opens journalPath for appending
+    bool openJournal();
+
+    // Writes the formatted record to the log
+    void appendRecord();
+
+    // Moves the current log to rotatedPath (merging if an older rotation is still there)
+    bool rotate();
+
+    // Applies every record in one log file; returns how many were applied
+    std::size_t replayFile(const std::string& path, TodoList& target);
+
+public:
+    explicit Journal(const std::string& snapshotPath = "data/tasks.txt",
+                     FsyncPolicy fsyncPolicy = FsyncPolicy::Never,
+                     FileFormat snapshotFormat = FileFormat::Text);
+
+    // Waits for a running compaction and detaches from the list
+    ~Journal() override;
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Loads the snapshot and replays the logs into the list, setting replayed to the number of records applied.
+    // A missing snapshot counts as empty. One that exists but can't be read (corrupt, truncated, checksum
+    // mismatch) returns false: the list is left as it was, the journal detaches, and attach and compact refuse
+    // to run, since a snapshot written from the logs alone would replace the unread one.
+    bool recover(TodoList& target, std::size_t& replayed);
+
+    // Starts logging every mutation of the list; false if the last recover couldn't read the snapshot
+    bool attach(TodoList& target);
+    void detach();
+
+    // Rotates the log and writes a fresh snapshot in the background; false if it couldn't start (not attached)
+    bool compact();
+
+    // Blocks until the background snapshot (if any) is done; returns whether it succeeded
+    bool waitForCompaction();
+
+    // Sets the journal size (in bytes) that triggers an automatic compaction; 0 turns it off
+    void setCompactionThreshold(std::size_t bytes);
+
+    // TodoListObserver: one record per mutation
+    void onTaskAdded(const Task& task) override;
+    void onTaskCompleted(const Task& task) override;
+    void onTaskRemoved(int id) override;
+    void onTasksCleared() override;
+};
+
+#endif // JOURNAL_H
\ No newline at end of file
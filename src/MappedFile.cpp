@@ -0,0 +1,39 @@
+#include "MappedFile.h"
+#include <fcntl.h>      // For open
+#include <sys/mman.h>   // For mmap, madvise and munmap
+#include <sys/stat.h>   // For fstat (file size)
+#include <unistd.h>     // For close
+
+// Opens and maps the file; the descriptor can be closed right away because the mapping keeps it alive
+MappedFile::MappedFile(const std::string& filePath) : data(nullptr), size(0), opened(false) {
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+        size = static_cast<std::size_t>(info.st_size);
+        if (size == 0) {
+            opened = true; // mmap refuses zero-length mappings, but an empty file is still valid
+        } else {
+            void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                // We read front to back, so ask the kernel for aggressive readahead
+                madvise(mapping, size, MADV_SEQUENTIAL);
+                data = static_cast<const char*>(mapping);
+                opened = true;
+            } else {
+                size = 0;
+            }
+        }
+    }
+
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data) {
+        munmap(const_cast<char*>(data), size);
+    }
+}
\ No newline at end of file
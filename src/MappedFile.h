@@ -0,0 +1,30 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// MappedFile maps a whole file read-only into memory and unmaps it when it goes out of scope (RAII).
+// An empty file maps to an empty view; failures are reported through isOpen().
+class MappedFile {
+private:
+    const char* data;   // Start of the mapping (nullptr if nothing is mapped)
+    std::size_t size;   // Length of the file in bytes
+    bool opened;        // True if the file could be opened and mapped
+
+public:
+    explicit MappedFile(const std::string& filePath);
+    ~MappedFile();
+
+    // A mapping has exactly one owner
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return opened; }
+
+    // The file contents (valid for as long as this object lives)
+    std::string_view contents() const { return std::string_view(data, size); }
+};
+
+#endif // MAPPED_FILE_H
\ No newline at end of file
@@ -0,0 +1,259 @@
+#include "Metrics.h"
+#include <bit>          // For std::bit_width
+#include <cstdio>       // For std::snprintf
+#include <mutex>
+
+namespace {
+
+const char* const operationNames[Metrics::operationCount] = {"add", "complete", "remove", "lookup", "save", "load"};
+const char* const counterNames[Metrics::counterCount] = {"parsed_bytes", "parsed_lines", "malformed_lines",
+                                                         "saved_tasks"};
+
+void appendNumber(std::string& out, std::uint64_t value) {
+    out += std::to_string(value);
+}
+
+// Nanoseconds as seconds, with enough digits to keep nanosecond resolution
+void appendSeconds(std::string& out, std::uint64_t nanoseconds) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.9g", static_cast<double>(nanoseconds) / 1e9);
+    out += text;
+}
+
+constexpr double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+const char* const quantileLabels[] = {"0.5", "0.9", "0.99", "0.999"};
+const char* const quantileKeys[] = {"p50_ns", "p90_ns", "p99_ns", "p999_ns"};
+
+} // namespace
+
+std::size_t Metrics::bucketOf(std::uint64_t nanoseconds) {
+    if (nanoseconds < subBuckets) {
+        return static_cast<std::size_t>(nanoseconds);
+    }
+    std::size_t exponent = std::bit_width(nanoseconds) - 1;  // >= 4
+    std::size_t bucket = (exponent - 3) * subBuckets + ((nanoseconds >> (exponent - 4)) & (subBuckets - 1));
+    return bucket < bucketCount ? bucket : bucketCount - 1;
+}
+
+std::uint64_t Metrics::bucketStart(std::size_t bucket) {
+    if (bucket < subBuckets) {
+        return bucket;
+    }
+    std::size_t exponent = bucket / subBuckets + 3;
+    return (subBuckets + bucket % subBuckets) << (exponent - 4);
+}
+
+std::uint64_t Metrics::OperationStats::quantile(double fraction) const {
+    if (samples == 0) {
+        return 0;
+    }
+    std::uint64_t rank = static_cast<std::uint64_t>(fraction * static_cast<double>(samples));
+    rank = rank < samples ? rank + 1 : samples;  // 1-based rank of the sample we want
+
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < buckets.size(); bucket++) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            if (bucket + 1 == buckets.size()) {
+                return maxNanoseconds;
+            }
+            std::uint64_t start = bucketStart(bucket);
+            std::uint64_t middle = start + (bucketStart(bucket + 1) - start) / 2;
+            return middle < maxNanoseconds ? middle : maxNanoseconds;
+        }
+    }
+    return maxNanoseconds;
+}
+
+const char* Metrics::nameOf(Operation operation) {
+    return operationNames[static_cast<std::size_t>(operation)];
+}
+
+const char* Metrics::nameOf(Counter counter) {
+    return counterNames[static_cast<std::size_t>(counter)];
+}
+
+#ifdef TODO_METRICS
+
+void Metrics::ThreadBlock::record(std::size_t operation, std::uint64_t nanoseconds) {
+    bump(samples[operation], 1);
+    bump(totalNanoseconds[operation], nanoseconds);
+    if (nanoseconds > maxNanoseconds[operation].load(std::memory_order_relaxed)) {
+        maxNanoseconds[operation].store(nanoseconds, std::memory_order_relaxed);
+    }
+    bump(buckets[operation][bucketOf(nanoseconds)], 1);
+}
+
+void Metrics::ThreadBlock::addTo(Snapshot& total) const {
+    for (std::size_t op = 0; op < operationCount; op++) {
+        OperationStats& stats = total.operations[op];
+        stats.calls += calls[op].load(std::memory_order_relaxed);
+        stats.samples += samples[op].load(std::memory_order_relaxed);
+        stats.totalNanoseconds += totalNanoseconds[op].load(std::memory_order_relaxed);
+        std::uint64_t max = maxNanoseconds[op].load(std::memory_order_relaxed);
+        stats.maxNanoseconds = max > stats.maxNanoseconds ? max : stats.maxNanoseconds;
+        for (std::size_t bucket = 0; bucket < bucketCount; bucket++) {
+            stats.buckets[bucket] += buckets[op][bucket].load(std::memory_order_relaxed);
+        }
+    }
+    for (std::size_t counter = 0; counter < counterCount; counter++) {
+        total.counters[counter] += counters[counter].load(std::memory_order_relaxed);
+    }
+}
+
+namespace {
+
+// Every live thread's block, plus the sum of the blocks of threads that have exited.
+// Never destroyed, so threads that outlive main's statics can still retire their blocks.
+struct Registry {
+    std::mutex mutex;
+    std::vector<Metrics::ThreadBlock*> live;
+    Metrics::Snapshot retired;
+    Metrics::ThreadBlock overflow;  // Shared by threads recording after their own block was retired
+};
+
+Registry& registry() {
+    static Registry* instance = [] {
+        Registry* created = new Registry();
+        for (auto& stats : created->retired.operations) {
+            stats.buckets.assign(Metrics::bucketCount, 0);
+        }
+        return created;
+    }();
+    return *instance;
+}
+
+} // namespace
+
+Metrics::ThreadBlock& Metrics::attachThread() {
+    // Folds the thread's block into the retired totals when the thread exits. Anything recorded after that
+    // (by other thread_local destructors) lands in the overflow block.
+    struct Retirement {
+        ThreadBlock* block = nullptr;
+
+        ~Retirement() {
+            Registry& all = registry();
+            std::lock_guard<std::mutex> guard(all.mutex);
+            block->addTo(all.retired);
+            std::erase(all.live, block);
+            delete block;
+            threadBlock = &all.overflow;
+        }
+    };
+    static thread_local Retirement retirement;
+
+    ThreadBlock* block = new ThreadBlock();
+    {
+        Registry& all = registry();
+        std::lock_guard<std::mutex> guard(all.mutex);
+        all.live.push_back(block);
+    }
+    retirement.block = block;
+    threadBlock = block;
+    return *block;
+}
+
+#endif // TODO_METRICS
+
+Metrics::Snapshot Metrics::snapshot() {
+    Snapshot total;
+    for (auto& stats : total.operations) {
+        stats.buckets.assign(bucketCount, 0);
+    }
+#ifdef TODO_METRICS
+    Registry& all = registry();
+    std::lock_guard<std::mutex> guard(all.mutex);
+    total = all.retired;
+    for (const ThreadBlock* block : all.live) {
+        block->addTo(total);
+    }
+    all.overflow.addTo(total);
+#endif
+    return total;
+}
+
+std::string Metrics::toPrometheus() {
+    Snapshot current = snapshot();
+    std::string out;
+
+    out += "# HELP todo_operations_total Calls of each TodoList / FileManager operation.\n";
+    out += "# TYPE todo_operations_total counter\n";
+    for (std::size_t op = 0; op < operationCount; op++) {
+        out += "todo_operations_total{operation=\"";
+        out += operationNames[op];
+        out += "\"} ";
+        appendNumber(out, current.operations[op].calls);
+        out += '\n';
+    }
+
+    out += "# HELP todo_operation_duration_seconds Latency of sampled operation calls.\n";
+    out += "# TYPE todo_operation_duration_seconds summary\n";
+    for (std::size_t op = 0; op < operationCount; op++) {
+        const OperationStats& stats = current.operations[op];
+        std::string label = std::string("operation=\"") + operationNames[op] + "\"";
+        for (std::size_t q = 0; q < std::size(quantiles); q++) {
+            out += "todo_operation_duration_seconds{" + label + ",quantile=\"" + quantileLabels[q] + "\"} ";
+            appendSeconds(out, stats.quantile(quantiles[q]));
+            out += '\n';
+        }
+        out += "todo_operation_duration_seconds_sum{" + label + "} ";
+        appendSeconds(out, stats.totalNanoseconds);
+        out += "\ntodo_operation_duration_seconds_count{" + label + "} ";
+        appendNumber(out, stats.samples);
+        out += '\n';
+    }
+
+    out += "# HELP todo_operation_duration_max_seconds Slowest sampled call of each operation.\n";
+    out += "# TYPE todo_operation_duration_max_seconds gauge\n";
+    for (std::size_t op = 0; op < operationCount; op++) {
+        out += "todo_operation_duration_max_seconds{operation=\"";
+        out += operationNames[op];
+        out += "\"} ";
+        appendSeconds(out, current.operations[op].maxNanoseconds);
+        out += '\n';
+    }
+
+    for (std::size_t counter = 0; counter < counterCount; counter++) {
+        std::string name = std::string("todo_") + counterNames[counter] + "_total";
+        out += "# TYPE " + name + " counter\n" + name + " ";
+        appendNumber(out, current.counters[counter]);
+        out += '\n';
+    }
+    return out;
+}
+
+std::string Metrics::toJson() {
+    Snapshot current = snapshot();
+    std::string out = "{\"operations\":{";
+
+    for (std::size_t op = 0; op < operationCount; op++) {
+        const OperationStats& stats = current.operations[op];
+        out += op == 0 ? "\"" : ",\"";
+        out += operationNames[op];
+        out += "\":{\"calls\":";
+        appendNumber(out, stats.calls);
+        out += ",\"samples\":";
+        appendNumber(out, stats.samples);
+        out += ",\"sum_ns\":";
+        appendNumber(out, stats.totalNanoseconds);
+        out += ",\"max_ns\":";
+        appendNumber(out, stats.maxNanoseconds);
+        for (std::size_t q = 0; q < std::size(quantiles); q++) {
+            out += ",\"";
+            out += quantileKeys[q];
+            out += "\":";
+            appendNumber(out, stats.quantile(quantiles[q]));
+        }
+        out += '}';
+    }
+
+    out += "},\"counters\":{";
+    for (std::size_t counter = 0; counter < counterCount; counter++) {
+        out += counter == 0 ? "\"" : ",\"";
+        out += counterNames[counter];
+        out += "\":";
+        appendNumber(out, current.counters[counter]);
+    }
+    out += "}}";
+    return out;
+}
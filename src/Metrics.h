@@ -0,0 +1,163 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Metrics is the built-in instrumentation for the hot paths: an exact call counter and a latency histogram per
+// operation, plus a few throughput counters for the loaders and the saver.
+//  - Every thread writes only to its own block of plain counters (no atomic read-modify-write, no locks);
+//    blocks are summed when a snapshot is taken, and a finished thread's block is folded into the totals.
+//  - Histograms are HDR-style: 16 linear sub-buckets per power of two of nanoseconds, so any recorded latency
+//    is off by at most 1/16 (6.25%), from 1 ns up to about 4.9 hours, in a fixed 656 buckets.
+//  - The in-memory operations take tens of nanoseconds, close to the cost of reading the clock, so they're
+//    timed on 1 call in 64 (counts stay exact); saves and loads are timed on every call.
+// Everything is compiled in only when TODO_METRICS is defined. Without it the TODO_METRICS_* macros expand to
+// nothing, so the instrumented code is exactly the uninstrumented code.
+class Metrics {
+public:
+    enum class Operation { Add, Complete, Remove, Lookup, Save, Load };
+    static constexpr std::size_t operationCount = 6;
+
+    enum class Counter {
+        ParsedBytes,     // Bytes of task text parsed by the loaders
+        ParsedLines,     // Non-empty lines parsed (including malformed ones)
+        MalformedLines,  // Lines skipped because they didn't parse
+        SavedTasks       // Tasks written by saves
+    };
+    static constexpr std::size_t counterCount = 4;
+
+    static constexpr std::size_t subBuckets = 16;      // Linear buckets per power of two
+    static constexpr std::size_t bucketCount = 656;    // Covers 0 .. 2^44 ns; longer latencies land in the last one
+
+    // Bucket index of a latency, and the smallest latency each bucket holds
+    static std::size_t bucketOf(std::uint64_t nanoseconds);
+    static std::uint64_t bucketStart(std::size_t bucket);
+
+    // One operation's numbers, summed over every thread
+    struct OperationStats {
+        std::uint64_t calls = 0;                 // Exact
+        std::uint64_t samples = 0;               // Calls whose latency was recorded
+        std::uint64_t totalNanoseconds = 0;      // Sum over the samples
+        std::uint64_t maxNanoseconds = 0;
+        std::vector<std::uint64_t> buckets;      // bucketCount sample counts
+
+        // Latency below which the given fraction of samples fall (middle of the bucket; 0 if there are none)
+        std::uint64_t quantile(double fraction) const;
+    };
+
+    struct Snapshot {
+        std::array<OperationStats, operationCount> operations;
+        std::array<std::uint64_t, counterCount> counters{};
+    };
+
+    // Sums every thread's numbers (and those of threads that have exited)
+    static Snapshot snapshot();
+
+    // The current numbers in the Prometheus text exposition format / as one JSON object
+    static std::string toPrometheus();
+    static std::string toJson();
+
+    static const char* nameOf(Operation operation);
+    static const char* nameOf(Counter counter);
+
+    // True if this build records anything
+    static constexpr bool enabled() {
+#ifdef TODO_METRICS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+#ifdef TODO_METRICS
+    // One thread's numbers. Written only by its owning thread (relaxed load + store, no read-modify-write)
+    // and read by snapshots.
+    struct ThreadBlock {
+        std::array<std::atomic<std::uint64_t>, operationCount> calls{};
+        std::array<std::atomic<std::uint64_t>, operationCount> samples{};
+        std::array<std::atomic<std::uint64_t>, operationCount> totalNanoseconds{};
+        std::array<std::atomic<std::uint64_t>, operationCount> maxNanoseconds{};
+        std::array<std::array<std::atomic<std::uint64_t>, bucketCount>, operationCount> buckets{};
+        std::array<std::atomic<std::uint64_t>, counterCount> counters{};
+        std::array<std::uint32_t, operationCount> ticks{};  // Sampling position (owner only)
+
+        static void bump(std::atomic<std::uint64_t>& value, std::uint64_t amount) {
+            value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        // Adds one sampled latency
+        void record(std::size_t operation, std::uint64_t nanoseconds);
+
+        // Adds this block's numbers to a snapshot
+        void addTo(Snapshot& total) const;
+    };
+
+    // Calls of each operation that get timed: 1 in (mask + 1)
+    static constexpr std::array<std::uint32_t, operationCount> sampleMask = {63, 63, 63, 63, 0, 0};
+
+    // The calling thread's block (a plain pointer, so reaching it is a single TLS load)
+    static ThreadBlock& localBlock() {
+        ThreadBlock* block = threadBlock;
+        return block ? *block : attachThread();
+    }
+
+    // Recording entry points; use the TODO_METRICS_* macros so they vanish when metrics are compiled out
+    static void count(Counter counter, std::uint64_t amount) {
+        ThreadBlock::bump(localBlock().counters[static_cast<std::size_t>(counter)], amount);
+    }
+
+    // Counts one call of an operation and, if the call is sampled, times it until the end of the scope
+    class Timer {
+    private:
+        ThreadBlock* block;  // The calling thread's block, or nullptr if this call isn't sampled
+        Operation operation;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit Timer(Operation operation) : block(nullptr), operation(operation) {
+            ThreadBlock& local = localBlock();
+            std::size_t op = static_cast<std::size_t>(operation);
+            ThreadBlock::bump(local.calls[op], 1);
+            if ((local.ticks[op]++ & sampleMask[op]) == 0) {
+                block = &local;
+                start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~Timer() {
+            if (block) {
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                block->record(static_cast<std::size_t>(operation), static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+        }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+    };
+
+private:
+    static inline thread_local ThreadBlock* threadBlock = nullptr;
+
+    // Creates and registers the calling thread's block (its first recording)
+    static ThreadBlock& attachThread();
+
+public:
+#endif
+};
+
+#ifdef TODO_METRICS
+#define TODO_METRICS_TIME(operation) Metrics::Timer todoMetricsTimer(Metrics::Operation::operation)
+#define TODO_METRICS_COUNT(counter, amount) Metrics::count(Metrics::Counter::counter, (amount))
+#else
+#define TODO_METRICS_TIME(operation) ((void)0)
+#define TODO_METRICS_COUNT(counter, amount) ((void)0)
+#endif
+
+#endif // METRICS_H
@@ -0,0 +1,156 @@
+#include "Task.h"
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <charconv>
+
+// Default constructor: sets safe defaults for everything
+Task::Task() : id(0), description(""), completed(false), creationDate(0), completionDate(0) {}
+
+Task::Task(const allocator_type& allocator)
+    : id(0), description(allocator), completed(false), creationDate(0), completionDate(0) {}
+
+// Main constructor: ensures every task has a valid ID and description
+Task::Task(int id, const std::string& description, const allocator_type& allocator)
+    : id(id), description(description, allocator), completed(false), completionDate(0) {
+
+    if (id <= 0) {
+        throw std::invalid_argument("Task ID must be positive");
+    }
+    if (description.empty()) {
+        throw std::invalid_argument("Task description cannot be empty");
+    }
+
+    creationDate = time(nullptr); // Timestamp when task is created
+}
+
+// Restoring constructor: rebuilds a task exactly as it was stored (e.g. in a TaskStore or snapshot)
+Task::Task(int id, const std::string& description, bool completed, time_t creationDate, time_t completionDate,
+           const allocator_type& allocator)
+    : id(id), description(description, allocator), completed(completed),
+      creationDate(creationDate), completionDate(completionDate) {
+
+    if (id <= 0) {
+        throw std::invalid_argument("Task ID must be positive");
+    }
+    if (description.empty()) {
+        throw std::invalid_argument("Task description cannot be empty");
+    }
+}
+
+// Record constructor: takes a parsed line as-is (parseTaskRecord already checked the ID)
+Task::Task(const TaskRecord& record, const allocator_type& allocator)
+    : id(record.id), description(record.description, allocator), completed(record.completed),
+      creationDate(record.creationDate), completionDate(record.completionDate) {}
+
+// Allocator-extended copy and move: the description is rebuilt in (or moved into) the given resource
+Task::Task(const Task& other, const allocator_type& allocator)
+    : id(other.id), description(other.description, allocator), completed(other.completed),
+      creationDate(other.creationDate), completionDate(other.completionDate) {}
+
+Task::Task(Task&& other, const allocator_type& allocator)
+    : id(other.id), description(std::move(other.description), allocator), completed(other.completed),
+      creationDate(other.creationDate), completionDate(other.completionDate) {}
+
+// Getters
+int Task::getId() const { return id; }
+const std::pmr::string& Task::getDescription() const { return description; }
+bool Task::isCompleted() const { return completed; }
+time_t Task::getCreationDate() const { return creationDate; }
+time_t Task::getCompletionDate() const { return completionDate; }
+
+// Setters with validation
+void Task::setId(int id) {
+    if (id <= 0) throw std::invalid_argument("Task ID must be positive");
+    this->id = id;
+}
+
+void Task::setDescription(const std::string& description) {
+    if (description.empty()) throw std::invalid_argument("Task description cannot be empty");
+    this->description = description;
+}
+
+// Marks the task complete and records the time
+void Task::markAsCompleted() {
+    completed = true;
+    completionDate = time(nullptr);
+}
+
+// Converts creation time to readable string
+std::string Task::getFormattedCreationDate() const {
+    struct tm timeinfo;
+    if (!localtime_r(&creationDate, &timeinfo)) return "Invalid date"; // Reentrant: no shared static buffer
+
+    char buffer[80];
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeinfo);
+    return std::string(buffer);
+}
+
+// Converts completion time to readable string, or shows it's not done
+std::string Task::getFormattedCompletionDate() const {
+    if (!completed) return "Not completed";
+
+    struct tm timeinfo;
+    if (!localtime_r(&completionDate, &timeinfo)) return "Invalid date"; // Reentrant: no shared static buffer
+
+    char buffer[80];
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeinfo);
+    return std::string(buffer);
+}
+
+// Serializes the task to a string for saving to file
+std::string Task::toString() const {
+    std::stringstream ss;
+    writeTo(ss);
+    return ss.str();
+}
+
+// Writes the same id|description|completed|created|completed_at line as toString, minus the copy
+void Task::writeTo(std::ostream& out) const {
+    out << id << '|' << description << '|' << (completed ? '1' : '0') << '|'
+        << creationDate << '|' << completionDate;
+}
+
+// Same line as writeTo, formatted with std::to_chars straight into the caller's buffer
+void Task::appendTo(std::string& out) const {
+    char digits[24];
+
+    out.append(digits, std::to_chars(digits, digits + sizeof(digits), id).ptr);
+    out += '|';
+    out += description;
+    out += '|';
+    out += completed ? '1' : '0';
+    out += '|';
+    out.append(digits, std::to_chars(digits, digits + sizeof(digits), creationDate).ptr);
+    out += '|';
+    out.append(digits, std::to_chars(digits, digits + sizeof(digits), completionDate).ptr);
+}
+
+// Parses a task from a string (e.g. when loading from file); throws on malformed input
+Task Task::fromString(const std::string& str) {
+    Task task;
+    TaskParseError error = parse(str, task);
+    if (error != TaskParseError::None) {
+        throw std::invalid_argument("Error parsing task: " + std::string(describeParseError(error)) + ": " + str);
+    }
+    return task;
+}
+
+// Non-throwing parse into an existing task; reusing the same Task keeps its description buffer
+TaskParseError Task::parse(std::string_view line, Task& task) {
+    TaskRecord record;
+    TaskParseError error = parseTaskRecord(line, record);
+    if (error == TaskParseError::None) {
+        task.assign(record);
+    }
+    return error;
+}
+
+// Copies a parsed record into this task
+void Task::assign(const TaskRecord& record) {
+    id = record.id;
+    description.assign(record.description);
+    completed = record.completed;
+    creationDate = record.creationDate;
+    completionDate = record.completionDate;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <string>
+#include <ctime>
+#include <memory_resource>
+#include <ostream>
+#include <string_view>
+#include "TaskParser.h"
+
+// Task represents a single to-do item with metadata like timestamps and completion status.
+// It is allocator-aware: inside a std::pmr container the description is allocated from the container's
+// memory resource, while plain copies (e.g. into a std::vector<Task>) go back to the default heap.
+class Task {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+private:
+    int id;                         // Unique task identifier
+    std::pmr::string description;   // Task details
+    bool completed;                 // Flag for completion status
+    time_t creationDate;            // When the task was created
+    time_t completionDate;          // When it was marked completed (if at all)
+
+public:
+    // Constructors (each takes an optional allocator for the description)
+    Task(); // Default constructor for flexibility (e.g. file loading)
+    explicit Task(const allocator_type& allocator);
+    Task(int id, const std::string& description, const allocator_type& allocator = {}); // Main constructor with validation
+    Task(int id, const std::string& description, bool completed,
+         time_t creationDate, time_t completionDate,
+         const allocator_type& allocator = {}); // Restores a stored task as-is (same validation)
+    explicit Task(const TaskRecord& record, const allocator_type& allocator = {}); // From a parsed line, like parse
+
+    // Copies and moves; the allocator-extended forms let std::pmr containers place tasks in their resource
+    Task(const Task& other) = default;
+    Task(Task&& other) noexcept = default;
+    Task(const Task& other, const allocator_type& allocator);
+    Task(Task&& other, const allocator_type& allocator);
+    Task& operator=(const Task& other) = default;
+    Task& operator=(Task&& other) = default;
+
+    // Basic accessors
+    int getId() const;
+    const std::pmr::string& getDescription() const; // Reference, so reading it never copies the string
+    std::string_view getDescriptionView() const { return description; }
+    bool isCompleted() const;
+    time_t getCreationDate() const;
+    time_t getCompletionDate() const;
+
+    // Mutators with validation
+    void setId(int id);
+    void setDescription(const std::string& description);
+
+    // Actions
+    void markAsCompleted();                         // Sets completion and timestamps it
+    std::string getFormattedCreationDate() const;   // For readable display (see TimestampFormatter for bulk use)
+    std::string getFormattedCompletionDate() const;
+
+    // For saving/loading to disk
+    std::string toString() const;                   // Serialize to string
+    void writeTo(std::ostream& out) const;          // Serialize straight into a stream (no temporary string)
+    void appendTo(std::string& out) const;          // Serialize onto the end of a buffer (no allocation once it's big enough)
+    static Task fromString(const std::string& str); // Parse from string (throws std::invalid_argument)
+    static TaskParseError parse(std::string_view line, Task& task); // Parse without throwing
+    void assign(const TaskRecord& record);          // Overwrite every field from a parsed record
+};
+
+#endif // TASK_H
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef TASK_FILTER_H
+#define TASK_FILTER_H
+
+#include <ctime>
+#include <limits>
+#include "Task.h"
+
+// TaskFilter describes a status + date-range selection over tasks.
+// Every bound is inclusive, and the defaults let everything through.
+struct TaskFilter {
+    // Which completion status to keep
+    enum class Status { Any, Completed, Pending };
+
+    Status status = Status::Any;
+    time_t createdFrom = std::numeric_limits<time_t>::min();    // Earliest creation date to keep
+    time_t createdTo = std::numeric_limits<time_t>::max();      // Latest creation date to keep
+    time_t completedFrom = std::numeric_limits<time_t>::min();  // Earliest completion date to keep
+    time_t completedTo = std::numeric_limits<time_t>::max();    // Latest completion date to keep
+
+    // True if the completion-date bounds were narrowed (pending tasks can never match them then)
+    bool hasCompletionRange() const {
+        return completedFrom != std::numeric_limits<time_t>::min() ||
+               completedTo != std::numeric_limits<time_t>::max();
+    }
+
+    // Checks a single set of task fields against the filter
+    bool matches(bool completed, time_t creationDate, time_t completionDate) const {
+        if (status == Status::Completed && !completed) return false;
+        if (status == Status::Pending && completed) return false;
+        if (creationDate < createdFrom || creationDate > createdTo) return false;
+        if (hasCompletionRange() &&
+            (!completed || completionDate < completedFrom || completionDate > completedTo)) return false;
+        return true;
+    }
+
+    bool matches(const Task& task) const {
+        return matches(task.isCompleted(), task.getCreationDate(), task.getCompletionDate());
+    }
+};
+
+#endif // TASK_FILTER_H
\ No newline at end of file
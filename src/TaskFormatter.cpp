@@ -0,0 +1,125 @@
+#include "TaskFormatter.h"
+#include <charconv>     // For std::to_chars on task IDs
+#include <cstring>      // For std::memcpy
+
+namespace {
+
+// Writes a value as exactly two digits
+void putTwoDigits(char* out, int value) {
+    out[0] = static_cast<char>('0' + value / 10);
+    out[1] = static_cast<char>('0' + value % 10);
+}
+
+// Writes a value as exactly four digits (years before 0 or after 9999 are cut, like strftime would pad them)
+void putFourDigits(char* out, int value) {
+    putTwoDigits(out, (value / 100) % 100);
+    putTwoDigits(out + 2, value % 100);
+}
+
+} // namespace
+
+TimestampFormatter::TimestampFormatter() : windowHour(0), windowStart(0), windowEnd(0), prefix{} {}
+
+bool TimestampFormatter::format(time_t time, char* out) {
+    if (time < windowStart || time >= windowEnd) {
+        std::tm local{};
+        if (!localtime_r(&time, &local) || local.tm_year + 1900 < 0 || local.tm_year + 1900 > 9999) {
+            return false;
+        }
+        putFourDigits(prefix, local.tm_year + 1900);
+        prefix[4] = '-';
+        putTwoDigits(prefix + 5, local.tm_mon + 1);
+        prefix[7] = '-';
+        putTwoDigits(prefix + 8, local.tm_mday);
+        prefix[10] = ' ';
+        putTwoDigits(prefix + 11, local.tm_hour);
+        prefix[13] = ':';
+
+        // The hour only counts as cached up to its ends if they really are HH:00:00 and HH:59:59 (they aren't
+        // when a clock change lands mid-hour); otherwise the window is narrowed to this time
+        time_t hourStart = time - (local.tm_min * 60 + (local.tm_sec > 59 ? 59 : local.tm_sec));
+        std::tm start{};
+        bool wholeHour = localtime_r(&hourStart, &start) && start.tm_hour == local.tm_hour &&
+                         start.tm_min == 0 && start.tm_sec == 0;
+        time_t hourEnd = hourStart + 3599;
+        std::tm last{};
+        bool hourRunsOut = localtime_r(&hourEnd, &last) && last.tm_hour == local.tm_hour &&
+                           last.tm_min == 59 && last.tm_sec == 59;
+        windowHour = hourStart;
+        windowStart = wholeHour ? hourStart : time;
+        windowEnd = hourRunsOut ? hourStart + 3600 : time + 1;
+    }
+
+    int offset = static_cast<int>(time - windowHour);
+    std::memcpy(out, prefix, sizeof(prefix));
+    putTwoDigits(out + 14, offset / 60);
+    out[16] = ':';
+    putTwoDigits(out + 17, offset % 60);
+    return true;
+}
+
+void TimestampFormatter::append(time_t time, std::string& out) {
+    char text[length];
+    if (format(time, text)) {
+        out.append(text, length);
+    } else {
+        out += "Invalid date";
+    }
+}
+
+TaskTableWriter::TaskTableWriter(std::ostream& out) : out(out) {}
+
+void TaskTableWriter::appendPadded(std::string_view text, std::size_t width) {
+    buffer += text;
+    if (text.size() < width) {
+        buffer.append(width - text.size(), ' ');
+    }
+}
+
+void TaskTableWriter::write(const TaskView& tasks) {
+    buffer.clear();
+    buffer.reserve(flushThreshold + 256);
+
+    // Table header
+    buffer += "\n----- Your Tasks -----\n";
+    appendPadded("ID", 5);
+    buffer += " | ";
+    appendPadded("STATUS", 8);
+    buffer += " | ";
+    appendPadded("DESCRIPTION", 30);
+    buffer += " | CREATED ON\n";
+    buffer.append(70, '-');
+    buffer += '\n';
+
+    // One row per task; long descriptions are cut to 27 characters plus "..."
+    for (const Task& task : tasks) {
+        char digits[16];
+        auto [end, error] = std::to_chars(digits, digits + sizeof(digits), task.getId());
+        appendPadded(std::string_view(digits, end - digits), 5);
+        buffer += task.isCompleted() ? " | DONE     | " : " | PENDING  | ";
+
+        std::string_view description = task.getDescriptionView();
+        if (description.size() > 27) {
+            buffer += description.substr(0, 27);
+            buffer += "...";
+        } else {
+            appendPadded(description, 30);
+        }
+        buffer += " | ";
+        dates.append(task.getCreationDate(), buffer);
+        buffer += '\n';
+
+        if (buffer.size() >= flushThreshold) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+
+    // Table footer
+    buffer.append(70, '-');
+    buffer += "\nTotal: ";
+    buffer += std::to_string(tasks.size());
+    buffer += " task(s)\n";
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+}
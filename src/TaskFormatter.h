@@ -0,0 +1,55 @@
+#ifndef TASK_FORMATTER_H
+#define TASK_FORMATTER_H
+
+#include <cstddef>
+#include <ctime>
+#include <ostream>
+#include <string>
+#include "TaskView.h"
+
+// TimestampFormatter renders times as local "YYYY-MM-DD HH:MM:SS" without calling localtime for each one.
+// It remembers the local hour the last conversion fell in: the "YYYY-MM-DD HH:" prefix is kept, and any
+// time inside that hour only needs its minutes and seconds filled in. Listings are mostly in creation order,
+// so a whole table usually costs one localtime_r per hour of timestamps.
+// Conversions use localtime_r, so separate formatters can be used on separate threads.
+class TimestampFormatter {
+private:
+    time_t windowHour;    // Time at which the cached local hour reads HH:00:00
+    time_t windowStart;   // First second the cache covers
+    time_t windowEnd;     // One past the last second it covers (windowStart == windowEnd: nothing cached)
+    char prefix[14];      // "YYYY-MM-DD HH:" of the cached hour
+
+public:
+    static constexpr std::size_t length = 19;  // Characters in a formatted timestamp
+
+    TimestampFormatter();
+
+    // Writes exactly `length` characters (no terminator) to out; false if the time can't be converted
+    bool format(time_t time, char* out);
+
+    // Appends the formatted time, or "Invalid date" if it can't be converted
+    void append(time_t time, std::string& out);
+};
+
+// TaskTableWriter renders the task table shown by the menu (ID, status, description cut to 27 characters,
+// creation date). Rows are formatted into one buffer with no stream formatting or temporary strings,
+// and handed to the stream in large blocks.
+class TaskTableWriter {
+private:
+    std::ostream& out;
+    std::string buffer;           // Pending output (written out whenever it passes flushThreshold)
+    TimestampFormatter dates;
+
+    static constexpr std::size_t flushThreshold = 64 * 1024;
+
+    // Appends text padded with spaces to width (never cut)
+    void appendPadded(std::string_view text, std::size_t width);
+
+public:
+    explicit TaskTableWriter(std::ostream& out);
+
+    // Writes the header, one row per task and the footer with the total
+    void write(const TaskView& tasks);
+};
+
+#endif // TASK_FORMATTER_H
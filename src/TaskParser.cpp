@@ -0,0 +1,71 @@
+#include "TaskParser.h"
+#include <charconv>     // For std::from_chars (no locale, no exceptions, no copies)
+#include <cstring>      // For memchr, which glibc implements with SIMD
+
+namespace {
+
+// Parses a whole field as an integer; fails on empty fields, stray characters and overflow
+template <typename Integer>
+bool parseInteger(std::string_view field, Integer& value) {
+    const char* first = field.data();
+    const char* last = field.data() + field.size();
+    auto [end, error] = std::from_chars(first, last, value);
+    return error == std::errc() && end == last && first != last;
+}
+
+// Cuts the next |-terminated field off the front of rest; returns false if there is no '|' left
+bool takeField(std::string_view& rest, std::string_view& field) {
+    const void* found = std::memchr(rest.data(), '|', rest.size());
+    if (!found) {
+        return false;
+    }
+    std::size_t length = static_cast<const char*>(found) - rest.data();
+    field = rest.substr(0, length);
+    rest.remove_prefix(length + 1);
+    return true;
+}
+
+} // namespace
+
+TaskParseError parseTaskRecord(std::string_view line, TaskRecord& record) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+
+    std::string_view idField, descriptionField, statusField, createdField, completedField;
+    std::string_view rest = line;
+    if (!takeField(rest, idField) || !takeField(rest, descriptionField) ||
+        !takeField(rest, statusField) || !takeField(rest, createdField)) {
+        return TaskParseError::TooFewFields;
+    }
+
+    // The last field runs to the next '|' (extra fields are ignored) or to the end of the line
+    if (!takeField(rest, completedField)) {
+        completedField = rest;
+    }
+
+    if (!parseInteger(idField, record.id) || record.id <= 0) {
+        return TaskParseError::InvalidId;
+    }
+    if (!parseInteger(createdField, record.creationDate)) {
+        return TaskParseError::InvalidCreationDate;
+    }
+    if (!parseInteger(completedField, record.completionDate)) {
+        return TaskParseError::InvalidCompletionDate;
+    }
+
+    record.description = descriptionField;
+    record.completed = statusField == "1";
+    return TaskParseError::None;
+}
+
+const char* describeParseError(TaskParseError error) {
+    switch (error) {
+        case TaskParseError::None: return "No error";
+        case TaskParseError::TooFewFields: return "Invalid task string format";
+        case TaskParseError::InvalidId: return "Invalid task ID";
+        case TaskParseError::InvalidCreationDate: return "Invalid creation date";
+        case TaskParseError::InvalidCompletionDate: return "Invalid completion date";
+    }
+    return "Unknown error";
+}
\ No newline at end of file
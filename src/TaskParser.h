@@ -0,0 +1,33 @@
+#ifndef TASK_PARSER_H
+#define TASK_PARSER_H
+
+#include <ctime>
+#include <string_view>
+
+// TaskRecord is one parsed id|description|completed|created|completed_at line.
+// The description points into the parsed line, so nothing is allocated.
+struct TaskRecord {
+    int id = 0;
+    std::string_view description;
+    bool completed = false;
+    time_t creationDate = 0;
+    time_t completionDate = 0;
+};
+
+// Why a line could not be parsed (None means success)
+enum class TaskParseError {
+    None,
+    TooFewFields,           // Fewer than five |-separated fields
+    InvalidId,              // ID isn't a positive integer that fits in an int
+    InvalidCreationDate,    // Creation timestamp isn't an integer
+    InvalidCompletionDate   // Completion timestamp isn't an integer
+};
+
+// Parses a line in the Task::toString format without throwing or allocating.
+// Fields after the fifth are ignored and a trailing '\r' (CRLF files) is dropped.
+TaskParseError parseTaskRecord(std::string_view line, TaskRecord& record);
+
+// Human-readable message for an error code, for warnings and exceptions
+const char* describeParseError(TaskParseError error);
+
+#endif // TASK_PARSER_H
\ No newline at end of file
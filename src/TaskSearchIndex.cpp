@@ -0,0 +1,174 @@
+#include "TaskSearchIndex.h"
+#include <algorithm>
+#include <bit>          // For std::countr_zero when reading the slot bitmap
+#include <string.h>     // For memmem
+
+TaskQuery TaskQuery::parse(std::string_view text) {
+    TaskQuery query;
+    bool askedForWords = false;
+
+    while (!text.empty()) {
+        std::size_t start = text.find_first_not_of(" \t");
+        if (start == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(start);
+
+        // A quoted run is taken verbatim, spaces included
+        if (text.front() == '"') {
+            std::size_t close = text.find('"', 1);
+            std::size_t length = close == std::string_view::npos ? text.size() - 1 : close - 1;
+            query.substring = std::string(text.substr(1, length));
+            text.remove_prefix(close == std::string_view::npos ? text.size() : close + 1);
+            continue;
+        }
+
+        std::size_t end = text.find_first_of(" \t");
+        std::string_view token = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end);
+
+        if (token == "OR") {
+            query.mode = Mode::Any;
+        } else if (token == "status:pending") {
+            query.status = TaskView::Filter::Pending;
+        } else if (token == "status:completed") {
+            query.status = TaskView::Filter::Completed;
+        } else {
+            // Punctuation splits words the same way it does in descriptions; with a trailing '*' the last
+            // word is the prefix ("foo-bar*" is the word foo and the prefix bar)
+            bool isPrefix = token.back() == '*';
+            std::vector<std::string> words;
+            TaskSearchIndex::tokenize(isPrefix ? token.substr(0, token.size() - 1) : token,
+                                      [&words](std::string_view word) { words.emplace_back(word); });
+            askedForWords = true;
+            if (isPrefix && !words.empty()) {
+                query.prefixes.push_back(std::move(words.back()));
+                words.pop_back();
+            }
+            query.terms.insert(query.terms.end(), words.begin(), words.end());
+        }
+    }
+
+    query.matchesNothing = askedForWords && query.terms.empty() && query.prefixes.empty();
+    return query;
+}
+
+std::string TaskSearchIndex::normalize(std::string_view word) {
+    std::string normalized(word);
+    for (char& c : normalized) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return normalized;
+}
+
+void TaskSearchIndex::add(std::size_t slot, std::string_view description) {
+    auto compactSlot = static_cast<std::uint32_t>(slot);
+    tokenize(description, [this, compactSlot](std::string_view word) {
+        auto it = postings.find(word);
+        if (it == postings.end()) {
+            it = postings.emplace(std::string(word), Postings()).first;
+        }
+
+        std::vector<std::uint32_t>& slots = it->second.slots;
+        if (!slots.empty() && slots.back() >= compactSlot) {
+            if (slots.back() == compactSlot) {
+                return; // Word repeated within the same description
+            }
+            it->second.sorted = false;
+        }
+        slots.push_back(compactSlot);
+    });
+}
+
+void TaskSearchIndex::markChanged(std::size_t slot) {
+    changedSlots.insert(static_cast<std::uint32_t>(slot));
+}
+
+const std::vector<std::uint32_t>& TaskSearchIndex::settle(Postings& list) {
+    if (!list.sorted) {
+        std::sort(list.slots.begin(), list.slots.end());
+        list.slots.erase(std::unique(list.slots.begin(), list.slots.end()), list.slots.end());
+        list.sorted = true;
+    }
+    return list.slots;
+}
+
+const std::vector<std::uint32_t>& TaskSearchIndex::term(std::string_view word) {
+    static const std::vector<std::uint32_t> none;
+    auto it = postings.find(word);
+    return it == postings.end() ? none : settle(it->second);
+}
+
+// Prefixes share a contiguous run of the ordered map. Its lists are combined in one pass, not merged one
+// at a time (which costs the size of the result for every matching word): through a bitmap over the slots
+// when they are dense enough, otherwise by concatenating and sorting once.
+std::vector<std::uint32_t> TaskSearchIndex::prefix(std::string_view start) {
+    std::vector<const std::vector<std::uint32_t>*> lists;
+    std::size_t total = 0;
+    std::uint32_t lastSlot = 0;
+    for (auto it = postings.lower_bound(start);
+         it != postings.end() && std::string_view(it->first).substr(0, start.size()) == start; ++it) {
+        const std::vector<std::uint32_t>& slots = settle(it->second);
+        if (!slots.empty()) {
+            lists.push_back(&slots);
+            total += slots.size();
+            lastSlot = std::max(lastSlot, slots.back());
+        }
+    }
+
+    std::vector<std::uint32_t> merged;
+    if (lists.size() == 1) {
+        merged = *lists.front();
+    } else if (lists.size() > 1 && lastSlot / 64 < total) {
+        std::vector<std::uint64_t> bits(lastSlot / 64 + 1);
+        for (const std::vector<std::uint32_t>* slots : lists) {
+            for (std::uint32_t slot : *slots) {
+                bits[slot / 64] |= std::uint64_t(1) << (slot % 64);
+            }
+        }
+        merged.reserve(total);
+        for (std::size_t word = 0; word < bits.size(); word++) {
+            for (std::uint64_t rest = bits[word]; rest != 0; rest &= rest - 1) {
+                merged.push_back(static_cast<std::uint32_t>(word * 64 + std::countr_zero(rest)));
+            }
+        }
+    } else if (lists.size() > 1) {
+        merged.reserve(total);
+        for (const std::vector<std::uint32_t>* slots : lists) {
+            merged.insert(merged.end(), slots->begin(), slots->end());
+        }
+        std::sort(merged.begin(), merged.end());
+        merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+    }
+    return merged;
+}
+
+void TaskSearchIndex::clear() {
+    postings.clear();
+    changedSlots.clear();
+}
+
+bool TaskSearchIndex::hasWord(std::string_view description, std::string_view word) {
+    bool found = false;
+    tokenize(description, [&found, word](std::string_view candidate) {
+        found = found || candidate == word;
+    });
+    return found;
+}
+
+bool TaskSearchIndex::hasPrefix(std::string_view description, std::string_view start) {
+    bool found = false;
+    tokenize(description, [&found, start](std::string_view candidate) {
+        found = found || candidate.substr(0, start.size()) == start;
+    });
+    return found;
+}
+
+bool TaskSearchIndex::containsSubstring(std::string_view haystack, std::string_view needle) {
+    if (needle.empty()) {
+        return true;
+    }
+    return memmem(haystack.data(), haystack.size(), needle.data(), needle.size()) != nullptr;
+}
@@ -0,0 +1,103 @@
+#ifndef TASK_SEARCH_INDEX_H
+#define TASK_SEARCH_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+#include "TaskView.h"
+
+// TaskQuery is one search over task descriptions.
+// Terms and prefixes match whole words (case-insensitive); they are combined with AND or OR.
+// The substring, if any, must also appear verbatim (case-sensitive) and is checked by scanning.
+struct TaskQuery {
+    enum class Mode { All, Any };   // AND / OR over terms and prefixes
+
+    std::vector<std::string> terms;     // Words that must appear
+    std::vector<std::string> prefixes;  // Word prefixes that must appear
+    Mode mode = Mode::All;
+    TaskView::Filter status = TaskView::Filter::All;
+    std::string substring;              // Raw text that must appear (empty = no constraint)
+    bool matchesNothing = false;        // Set by parse when every word given was only punctuation
+
+    // Parses the query syntax used by batch mode:
+    //   word      whole word            pre*       word prefix
+    //   OR        combine with OR       "text"     raw substring
+    //   status:pending / status:completed
+    // Words are split at punctuation like descriptions are; a query whose words were all punctuation
+    // matches no task (rather than every one)
+    static TaskQuery parse(std::string_view text);
+};
+
+// TaskSearchIndex is an inverted index from lowercased description words to the slots that contain them.
+// Slots only ever get appended (new tasks land at the end), so posting lists stay sorted for free; an
+// out-of-order append just marks the list for a lazy sort. Removals aren't applied at all: the owner
+// skips tombstoned slots while answering. A slot whose description was replaced is remembered as
+// changed, and its matches are re-checked against the new text.
+// Slots are stored as 32 bits to halve the index size (a list would need 4 billion tasks to overflow).
+class TaskSearchIndex {
+private:
+    struct Postings {
+        std::vector<std::uint32_t> slots;  // Slots containing the word
+        bool sorted = true;                // False after an out-of-order append
+    };
+
+    std::map<std::string, Postings, std::less<>> postings; // Ordered, so prefixes are a contiguous range
+    std::unordered_set<std::uint32_t> changedSlots;         // Slots whose postings may include stale words
+
+    // Sorts and deduplicates a posting list if it needs it
+    static const std::vector<std::uint32_t>& settle(Postings& list);
+
+public:
+    // Calls emit(std::string_view word) for each lowercased word (runs of letters, digits and non-ASCII bytes)
+    template <typename Emit>
+    static void tokenize(std::string_view text, Emit&& emit);
+
+    // Lowercases ASCII letters, the same way tokenize does
+    static std::string normalize(std::string_view word);
+
+    // Indexes the words of a description under the given slot
+    void add(std::size_t slot, std::string_view description);
+
+    // Marks a slot whose description was replaced (call add with the new text as well)
+    void markChanged(std::size_t slot);
+
+    // True if results for this slot must be re-checked against its current description
+    bool isChanged(std::size_t slot) const { return changedSlots.count(static_cast<std::uint32_t>(slot)) != 0; }
+
+    // Sorted slots containing the (normalized) word; empty if none
+    const std::vector<std::uint32_t>& term(std::string_view word);
+
+    // Sorted union of every posting list whose word starts with the (normalized) prefix
+    std::vector<std::uint32_t> prefix(std::string_view start);
+
+    // Drops the whole index
+    void clear();
+
+    // True if the description contains the word / a word with the prefix (both already normalized)
+    static bool hasWord(std::string_view description, std::string_view word);
+    static bool hasPrefix(std::string_view description, std::string_view start);
+
+    // True if needle occurs in haystack (memmem, which glibc vectorizes)
+    static bool containsSubstring(std::string_view haystack, std::string_view needle);
+};
+
+template <typename Emit>
+void TaskSearchIndex::tokenize(std::string_view text, Emit&& emit) {
+    std::string word;
+    for (std::size_t i = 0; i <= text.size(); i++) {
+        unsigned char c = i < text.size() ? static_cast<unsigned char>(text[i]) : ' ';
+        bool wordChar = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+        if (wordChar) {
+            word += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : static_cast<char>(c);
+        } else if (!word.empty()) {
+            emit(std::string_view(word));
+            word.clear();
+        }
+    }
+}
+
+#endif // TASK_SEARCH_INDEX_H
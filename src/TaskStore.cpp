@@ -0,0 +1,223 @@
+#include "TaskStore.h"
+#include <bit>          // For std::popcount and std::countr_zero on the status bitmap
+#include <functional>   // For std::hash<std::string_view>
+#include <limits>       // For std::numeric_limits
+#include <stdexcept>    // For std::length_error
+
+// Pre-sizes every column so bulk appends don't reallocate
+void TaskStore::reserve(std::size_t rowCount) {
+    ids.reserve(rowCount);
+    completedBits.reserve((rowCount + 63) / 64);
+    creationDates.reserve(rowCount);
+    completionDates.reserve(rowCount);
+    descriptionOffsets.reserve(rowCount);
+    descriptionLengths.reserve(rowCount);
+}
+
+void TaskStore::append(const Task& task) {
+    append(task.getId(), task.getDescription(), task.isCompleted(),
+           task.getCreationDate(), task.getCompletionDate());
+}
+
+// Appends a row to every column
+void TaskStore::append(int id, std::string_view description, bool completed,
+                       time_t creationDate, time_t completionDate) {
+    std::size_t row = ids.size();
+    if (row >= std::numeric_limits<std::uint32_t>::max() ||
+        description.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("TaskStore is limited to 2^32 rows and 4 GB descriptions");
+    }
+
+    ids.push_back(id);
+    if (row % 64 == 0) {
+        completedBits.push_back(0);
+    }
+    if (completed) {
+        completedBits[row / 64] |= std::uint64_t(1) << (row % 64);
+    }
+    creationDates.push_back(creationDate);
+    completionDates.push_back(completionDate);
+    intern(row, description);
+}
+
+// Linear-probing lookup; on a miss the text is copied to the end of the arena
+void TaskStore::intern(std::size_t row, std::string_view description) {
+    if (internTableStale) {
+        rebuildInternTable();
+    }
+    if ((internedCount + 1) * 2 > internSlots.size()) {
+        growInternTable();
+    }
+
+    std::size_t mask = internSlots.size() - 1;
+    std::size_t slot = std::hash<std::string_view>{}(description) & mask;
+
+    while (internSlots[slot] != 0) {
+        std::size_t existingRow = internSlots[slot] - 1;
+        if (getDescription(existingRow) == description) {
+            descriptionOffsets.push_back(descriptionOffsets[existingRow]);
+            descriptionLengths.push_back(descriptionLengths[existingRow]);
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    internSlots[slot] = static_cast<std::uint32_t>(row + 1);
+    internedCount++;
+    descriptionOffsets.push_back(arena.size());
+    descriptionLengths.push_back(static_cast<std::uint32_t>(description.size()));
+    arena.append(description);
+}
+
+// Keeps the load factor at or below one half
+void TaskStore::growInternTable() {
+    std::vector<std::uint32_t> oldSlots = std::move(internSlots);
+    internSlots.assign(oldSlots.empty() ? 1024 : oldSlots.size() * 2, 0);
+    std::size_t mask = internSlots.size() - 1;
+
+    for (std::uint32_t entry : oldSlots) {
+        if (entry != 0) {
+            std::size_t slot = std::hash<std::string_view>{}(getDescription(entry - 1)) & mask;
+            while (internSlots[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+            internSlots[slot] = entry;
+        }
+    }
+}
+
+// Adopted rows keep their own copy of the text; only later appends are deduplicated against them
+void TaskStore::rebuildInternTable() {
+    internTableStale = false;
+    internedCount = 0;
+    std::size_t slotCount = 1024;
+    while (slotCount < size() * 2) {
+        slotCount *= 2;
+    }
+    internSlots.assign(slotCount, 0);
+    std::size_t mask = slotCount - 1;
+
+    for (std::size_t row = 0; row < size(); row++) {
+        std::string_view description = getDescription(row);
+        std::size_t slot = std::hash<std::string_view>{}(description) & mask;
+        bool seen = false;
+        while (internSlots[slot] != 0) {
+            if (getDescription(internSlots[slot] - 1) == description) {
+                seen = true;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        if (!seen) {
+            internSlots[slot] = static_cast<std::uint32_t>(row + 1);
+            internedCount++;
+        }
+    }
+}
+
+void TaskStore::adoptColumns(std::vector<int>&& ids, std::vector<std::uint64_t>&& completedBits,
+                             std::vector<time_t>&& creationDates, std::vector<time_t>&& completionDates,
+                             std::vector<std::uint32_t>&& descriptionLengths, std::string&& descriptionBlob) {
+    if (ids.size() >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("TaskStore is limited to 2^32 rows");
+    }
+
+    this->ids = std::move(ids);
+    this->completedBits = std::move(completedBits);
+    this->creationDates = std::move(creationDates);
+    this->completionDates = std::move(completionDates);
+    this->descriptionLengths = std::move(descriptionLengths);
+    arena = std::move(descriptionBlob);
+
+    // Offsets are just the running total of the lengths
+    descriptionOffsets.resize(this->ids.size());
+    std::uint64_t offset = 0;
+    for (std::size_t row = 0; row < this->ids.size(); row++) {
+        descriptionOffsets[row] = offset;
+        offset += this->descriptionLengths[row];
+    }
+
+    internSlots.clear();
+    internedCount = 0;
+    internTableStale = true;
+}
+
+// Materializes a row back into a Task (exactly as stored, like a parsed file line)
+Task TaskStore::toTask(std::size_t row) const {
+    TaskRecord record;
+    record.id = ids[row];
+    record.description = getDescription(row);
+    record.completed = isCompleted(row);
+    record.creationDate = creationDates[row];
+    record.completionDate = completionDates[row];
+
+    Task task;
+    task.assign(record);
+    return task;
+}
+
+std::size_t TaskStore::countCompleted() const {
+    std::size_t count = 0;
+    for (std::uint64_t word : completedBits) {
+        count += std::popcount(word);
+    }
+    return count;
+}
+
+// Status-only filters walk the bitmap 64 rows at a time; date filters read just the date columns
+std::vector<std::size_t> TaskStore::findRows(const TaskFilter& filter) const {
+    std::vector<std::size_t> rows;
+    std::size_t rowCount = size();
+
+    // A completion-date range can only match completed rows
+    bool completedOnly = filter.status == TaskFilter::Status::Completed || filter.hasCompletionRange();
+    if (completedOnly && filter.status == TaskFilter::Status::Pending) {
+        return rows;
+    }
+
+    for (std::size_t wordIndex = 0; wordIndex < completedBits.size(); wordIndex++) {
+        std::uint64_t word = completedBits[wordIndex];
+        if (filter.status == TaskFilter::Status::Pending) {
+            word = ~word;
+        } else if (!completedOnly) {
+            word = ~std::uint64_t(0);
+        }
+
+        // Mask off bits past the last row in the final word
+        std::size_t base = wordIndex * 64;
+        if (rowCount - base < 64) {
+            word &= (std::uint64_t(1) << (rowCount - base)) - 1;
+        }
+
+        while (word != 0) {
+            std::size_t row = base + std::countr_zero(word);
+            word &= word - 1;
+
+            time_t created = creationDates[row];
+            if (created < filter.createdFrom || created > filter.createdTo) continue;
+            if (filter.hasCompletionRange()) {
+                time_t completedAt = completionDates[row];
+                if (completedAt < filter.completedFrom || completedAt > filter.completedTo) continue;
+            }
+            rows.push_back(row);
+        }
+    }
+
+    return rows;
+}
+
+std::size_t TaskStore::memoryUsage() const {
+    return ids.capacity() * sizeof(int) +
+           completedBits.capacity() * sizeof(std::uint64_t) +
+           creationDates.capacity() * sizeof(time_t) +
+           completionDates.capacity() * sizeof(time_t) +
+           descriptionOffsets.capacity() * sizeof(std::uint64_t) +
+           descriptionLengths.capacity() * sizeof(std::uint32_t) +
+           arena.capacity() +
+           internSlots.capacity() * sizeof(std::uint32_t);
+}
+
+// Assigning a fresh store actually returns the memory (clear() alone would keep capacity)
+void TaskStore::clear() {
+    *this = TaskStore();
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef TASK_STORE_H
+#define TASK_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Task.h"
+#include "TaskFilter.h"
+
+// TaskStore keeps tasks column by column instead of as an array of Task objects.
+// Each field lives in its own dense vector (IDs, a completion bitmap, creation and completion dates),
+// and every description is packed into a single character arena and referenced by offset + length.
+// Identical descriptions are interned, so they are stored only once.
+// Status and date filters then only touch the columns they need, and a task costs 32 bytes of columns
+// (ID 4 + two dates 16 + offset 8 + length 4) plus one status bit and its (shared) text, versus
+// sizeof(Task) plus a heap block per long description.
+class TaskStore {
+private:
+    std::vector<int> ids;                    // Task IDs, one per row
+    std::vector<std::uint64_t> completedBits; // Completion status, one bit per row
+    std::vector<time_t> creationDates;       // Creation timestamps, one per row
+    std::vector<time_t> completionDates;     // Completion timestamps, one per row (0 if pending)
+    std::vector<std::uint64_t> descriptionOffsets; // Where each row's description starts in the arena
+    std::vector<std::uint32_t> descriptionLengths; // Length of each row's description
+    std::string arena;                       // All unique descriptions, back to back
+
+    // Open-addressing hash set used for interning: each slot holds (row + 1) of the first row that
+    // stored a given text, or 0 if empty. Four bytes per slot keeps it far smaller than a node-based map.
+    std::vector<std::uint32_t> internSlots;
+    std::size_t internedCount = 0;           // Number of distinct descriptions in the arena
+
+    bool internTableStale = false;           // True after adoptColumns, until the table is rebuilt
+
+    // Doubles the intern table and re-inserts every distinct description
+    void growInternTable();
+
+    // Rebuilds the intern table from every row (after columns were adopted in bulk)
+    void rebuildInternTable();
+
+    // Stores the row's description, reusing an existing copy of the same text if there is one
+    void intern(std::size_t row, std::string_view description);
+
+public:
+    // Pre-sizes every column for the given number of rows
+    void reserve(std::size_t rowCount);
+
+    // Appends one task as a new row
+    void append(const Task& task);
+    void append(int id, std::string_view description, bool completed, time_t creationDate, time_t completionDate);
+
+    // Column accessors for a row (0-based, in insertion order)
+    std::size_t size() const { return ids.size(); }
+    int getId(std::size_t row) const { return ids[row]; }
+    bool isCompleted(std::size_t row) const { return (completedBits[row / 64] >> (row % 64)) & 1; }
+    time_t getCreationDate(std::size_t row) const { return creationDates[row]; }
+    time_t getCompletionDate(std::size_t row) const { return completionDates[row]; }
+    std::string_view getDescription(std::size_t row) const {
+        return std::string_view(arena).substr(descriptionOffsets[row], descriptionLengths[row]);
+    }
+
+    // Replaces the whole store with ready-made columns (e.g. straight from a binary snapshot).
+    // Descriptions are taken as one blob in row order, with each row's length; no per-row copy is made.
+    void adoptColumns(std::vector<int>&& ids, std::vector<std::uint64_t>&& completedBits,
+                      std::vector<time_t>&& creationDates, std::vector<time_t>&& completionDates,
+                      std::vector<std::uint32_t>&& descriptionLengths, std::string&& descriptionBlob);
+
+    // Rebuilds a full Task object for one row
+    Task toTask(std::size_t row) const;
+
+    // Counts completed rows straight from the bitmap (popcount per 64 rows)
+    std::size_t countCompleted() const;
+
+    // Returns the rows that match the filter, in insertion order; only the needed columns are read
+    std::vector<std::size_t> findRows(const TaskFilter& filter) const;
+
+    // Bytes reserved by the columns, the arena and the intern table
+    std::size_t memoryUsage() const;
+
+    // Drops every row and releases the column memory
+    void clear();
+};
+
+#endif // TASK_STORE_H
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "TaskStream.h"
+#include <cerrno>       // For errno / EINTR
+#include <cstring>      // For memchr and memmove
+#include <iostream>     // For warnings on std::cerr
+#include <string_view>
+#include <fcntl.h>      // For open and posix_fadvise
+#include <unistd.h>     // For read and close
+#include "BinarySnapshot.h"
+#include "Metrics.h"
+
+TaskStream::TaskStream(const std::string& filePath, const TaskFilter& filter, std::size_t chunkSize)
+    : fd(open(filePath.c_str(), O_RDONLY)), filter(filter), buffer(chunkSize > 0 ? chunkSize : defaultChunkSize),
+      begin(0), end(0), endOfFile(false), error(false), firstChunk(true), malformed(0),
+      bytesRead(0), linesParsed(0) {
+    if (fd < 0) {
+        endOfFile = true;
+        error = true;
+        return;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    // Lets the kernel read ahead aggressively while we're busy parsing
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+TaskStream::~TaskStream() {
+    TODO_METRICS_COUNT(ParsedBytes, bytesRead);
+    TODO_METRICS_COUNT(ParsedLines, linesParsed);
+    TODO_METRICS_COUNT(MalformedLines, malformed);
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+void TaskStream::refill() {
+    // Keep the partial line; only a line longer than the whole buffer makes it grow
+    std::size_t pending = end - begin;
+    if (begin > 0) {
+        std::memmove(buffer.data(), buffer.data() + begin, pending);
+    } else if (pending == buffer.size()) {
+        buffer.resize(buffer.size() * 2);
+    }
+    begin = 0;
+    end = pending;
+
+    ssize_t bytes = readMore();
+    if (bytes > 0 && firstChunk) {
+        firstChunk = false;
+        std::string_view head(buffer.data(), end + static_cast<std::size_t>(bytes));
+        if (BinarySnapshot::isBinarySnapshot(head)) {
+            std::cerr << "Error: Binary task files can't be streamed; load them instead." << std::endl;
+            endOfFile = true;
+            error = true;
+            return;
+        }
+        if (CompressedText::isCompressed(head)) {
+            // What was just read is compressed: hand it to the decoder and read text from there on
+            decoder = std::make_unique<CompressedText::StreamDecoder>(fd, head);
+            bytes = readMore();
+        }
+    }
+
+    if (bytes <= 0) {
+        endOfFile = true;
+        error = bytes < 0;
+        if (decoder && error) {
+            std::cerr << "Error: " << decoder->error() << std::endl;
+        }
+        return;
+    }
+    end += static_cast<std::size_t>(bytes);
+    bytesRead += static_cast<std::size_t>(bytes);
+}
+
+ssize_t TaskStream::readMore() {
+    if (decoder) {
+        return decoder->read(buffer.data() + end, buffer.size() - end);
+    }
+    ssize_t bytes;
+    do {
+        bytes = read(fd, buffer.data() + end, buffer.size() - end);
+    } while (bytes < 0 && errno == EINTR);
+    return bytes;
+}
+
+bool TaskStream::next(TaskRecord& record) {
+    while (true) {
+        const char* start = buffer.data() + begin;
+        const void* newline = std::memchr(start, '\n', end - begin);
+
+        std::string_view line;
+        if (newline) {
+            line = std::string_view(start, static_cast<const char*>(newline) - start);
+            begin += line.size() + 1;
+        } else if (!endOfFile) {
+            refill();
+            continue;
+        } else if (begin < end) {
+            line = std::string_view(start, end - begin); // Last line without a trailing newline
+            begin = end;
+        } else {
+            return false;
+        }
+
+        if (line.empty()) {
+            continue;
+        }
+
+        linesParsed++;
+        TaskParseError parseError = parseTaskRecord(line, record);
+        if (parseError != TaskParseError::None) {
+            malformed++;
+            std::cerr << "Error parsing task: " << describeParseError(parseError) << ": " << line << std::endl;
+            std::cerr << "Skipping malformed task entry." << std::endl;
+            continue;
+        }
+
+        // Filter pushdown: rejected records never leave the parser
+        if (filter.matches(record.completed, record.creationDate, record.completionDate)) {
+            return true;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef TASK_STREAM_H
+#define TASK_STREAM_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/types.h>  // For ssize_t
+#include "CompressedText.h"
+#include "TaskFilter.h"
+#include "TaskParser.h"
+
+// TaskStream reads a text task file front to back, one record at a time, without ever loading it whole.
+// The file is read with plain read() calls into a single fixed-size buffer (the kernel is told the access
+// is sequential, so it reads ahead while we parse), and a line cut by the end of a chunk is carried over
+// to the next one. Records are filtered right after parsing, before anything is copied, so filtered-out
+// tasks cost nothing but the parse. Memory use is one chunk (plus the longest line, if it's bigger),
+// however large the file is.
+// Compressed files are decompressed on the fly into the same buffer, so memory stays bounded for them too.
+// Binary snapshots are column-oriented and can't be streamed row by row; opening one sets failed().
+class TaskStream {
+private:
+    int fd;                       // Descriptor of the file (-1 if it couldn't be opened)
+    TaskFilter filter;            // Records that don't match are skipped
+    std::vector<char> buffer;     // The current chunk
+    std::size_t begin;            // First unconsumed byte in buffer
+    std::size_t end;              // One past the last valid byte in buffer
+    bool endOfFile;               // True once read() returned 0 (or failed)
+    bool error;                   // True after a read error, or if the file is a binary snapshot
+    bool firstChunk;              // True until the first chunk has been read (checked for the magic numbers)
+    std::unique_ptr<CompressedText::StreamDecoder> decoder; // Set once the file turned out to be compressed
+    std::size_t malformed;        // Lines skipped because they didn't parse
+    std::size_t bytesRead;        // Text bytes read so far (reported to Metrics when the stream closes)
+    std::size_t linesParsed;      // Non-empty lines handed to the parser so far
+
+    // Moves the unconsumed tail to the front of the buffer and reads more after it
+    void refill();
+
+    // Reads the next bytes of text into the buffer after end (decompressing them if needed)
+    ssize_t readMore();
+
+public:
+    static constexpr std::size_t defaultChunkSize = 1 << 20;
+
+    explicit TaskStream(const std::string& filePath, const TaskFilter& filter = TaskFilter(),
+                        std::size_t chunkSize = defaultChunkSize);
+    ~TaskStream();
+
+    TaskStream(const TaskStream&) = delete;
+    TaskStream& operator=(const TaskStream&) = delete;
+
+    // True if the file could be opened
+    bool isOpen() const { return fd >= 0; }
+
+    // Moves to the next record that passes the filter; false at the end of the file or on an error.
+    // record.description points into the stream's buffer and is only valid until the next call.
+    bool next(TaskRecord& record);
+
+    // True if reading stopped because of an error rather than the end of the file
+    bool failed() const { return error; }
+
+    // Number of malformed lines skipped so far (each is reported on std::cerr, like the loaders do)
+    std::size_t malformedLines() const { return malformed; }
+};
+
+#endif // TASK_STREAM_H
@@ -0,0 +1,90 @@
+#include "TaskTimeIndex.h"
+
+void TaskTimeIndex::insert(time_t time, std::size_t slot) {
+    Entry entry{time, slot};
+    if (inserted.empty() && (run.empty() || run.back() < entry)) {
+        run.push_back(entry);
+        return;
+    }
+    inserted.push_back(entry);
+    buffersSorted = false;
+    foldIfNeeded();
+}
+
+void TaskTimeIndex::erase(time_t time, std::size_t slot) {
+    Entry entry{time, slot};
+
+    // Taking back the most recent append is common (complete or remove right after add) and free
+    if (inserted.empty() && erased.empty() && !run.empty() && run.back() == entry) {
+        run.pop_back();
+        return;
+    }
+    erased.push_back(entry);
+    buffersSorted = false;
+    foldIfNeeded();
+}
+
+void TaskTimeIndex::assign(std::vector<Entry>&& entries) {
+    run = std::move(entries);
+    std::sort(run.begin(), run.end());
+    inserted.clear();
+    erased.clear();
+    buffersSorted = true;
+}
+
+void TaskTimeIndex::clear() {
+    run.clear();
+    inserted.clear();
+    erased.clear();
+    buffersSorted = true;
+}
+
+void TaskTimeIndex::sortBuffers() const {
+    if (!buffersSorted) {
+        std::sort(inserted.begin(), inserted.end());
+        std::sort(erased.begin(), erased.end());
+        buffersSorted = true;
+    }
+}
+
+// One linear merge pays for the run.size() / 8 updates that filled the buffers
+void TaskTimeIndex::foldIfNeeded() {
+    if (inserted.size() + erased.size() < run.size() / 8 + 64) {
+        return;
+    }
+
+    // Same walk as forEachBetween, but keeping whole entries
+    std::vector<Entry> merged;
+    merged.reserve(size());
+    sortBuffers();
+    auto runIt = run.begin(), insertIt = inserted.begin(), eraseIt = erased.begin();
+    while (runIt != run.end() || insertIt != inserted.end()) {
+        bool fromRun = runIt != run.end() && (insertIt == inserted.end() || !(*insertIt < *runIt));
+        const Entry& entry = fromRun ? *runIt++ : *insertIt++;
+        while (eraseIt != erased.end() && *eraseIt < entry) ++eraseIt;
+        if (eraseIt != erased.end() && *eraseIt == entry) {
+            ++eraseIt;
+            continue;
+        }
+        merged.push_back(entry);
+    }
+
+    run.swap(merged);
+    inserted.clear();
+    erased.clear();
+}
+
+std::size_t TaskTimeIndex::rankBefore(const Entry& bound) const {
+    auto rank = [&bound](const std::vector<Entry>& entries) {
+        return static_cast<std::size_t>(std::lower_bound(entries.begin(), entries.end(), bound) - entries.begin());
+    };
+    return rank(run) + rank(inserted) - rank(erased);
+}
+
+std::size_t TaskTimeIndex::countBetween(time_t from, time_t to) const {
+    if (to <= from) {
+        return 0;
+    }
+    sortBuffers();
+    return rankBefore(Entry{to, 0}) - rankBefore(Entry{from, 0});
+}
@@ -0,0 +1,105 @@
+#ifndef TASK_TIME_INDEX_H
+#define TASK_TIME_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <ctime>
+#include <vector>
+
+// Number of tasks whose timestamp falls on one local calendar day
+struct DayCount {
+    time_t dayStart;     // Local midnight that starts the day
+    std::size_t count;
+};
+
+// TaskTimeIndex keeps (timestamp, slot) pairs ordered by time, so range and rank queries are binary searches.
+// It is a sorted run plus two small buffers:
+//  - inserts that arrive in order (the usual case: "now" only grows) are appended straight to the run
+//  - other inserts go to an insert buffer, and erases to an erase buffer, instead of shifting the run
+// The buffers are sorted lazily by the next query and folded into the run once they reach 1/8 of it,
+// so every update is amortized O(1) and every query is O(log n) plus the size of its output.
+// An erase must name a pair that is currently in the index.
+class TaskTimeIndex {
+public:
+    struct Entry {
+        time_t time;
+        std::size_t slot;
+
+        bool operator<(const Entry& other) const {
+            return time != other.time ? time < other.time : slot < other.slot;
+        }
+        bool operator==(const Entry& other) const { return time == other.time && slot == other.slot; }
+    };
+
+private:
+    std::vector<Entry> run;              // Sorted
+    mutable std::vector<Entry> inserted; // Not yet in the run (sorted when buffersSorted)
+    mutable std::vector<Entry> erased;   // Cancel one matching entry of run/inserted (sorted when buffersSorted)
+    mutable bool buffersSorted = true;
+
+    // Sorts the buffers if an update touched them since the last query
+    void sortBuffers() const;
+
+    // Merges both buffers into the run if they've grown large enough
+    void foldIfNeeded();
+
+    // Number of entries strictly before the given pair, across run, insert buffer and erase buffer
+    std::size_t rankBefore(const Entry& bound) const;
+
+public:
+    // Adds / removes one pair
+    void insert(time_t time, std::size_t slot);
+    void erase(time_t time, std::size_t slot);
+
+    // Replaces the contents with the given pairs (in any order)
+    void assign(std::vector<Entry>&& entries);
+
+    void clear();
+
+    // Live entries in the index
+    std::size_t size() const { return run.size() + inserted.size() - erased.size(); }
+
+    // Number of entries with from <= time < to
+    std::size_t countBetween(time_t from, time_t to) const;
+
+    // Calls visit(slot) for entries with from <= time <= to, oldest first, until visit returns false
+    template <typename Visit>
+    void forEachBetween(time_t from, time_t to, Visit&& visit) const;
+};
+
+template <typename Visit>
+void TaskTimeIndex::forEachBetween(time_t from, time_t to, Visit&& visit) const {
+    sortBuffers();
+    Entry first{from, 0};
+    auto runIt = std::lower_bound(run.begin(), run.end(), first);
+    auto insertIt = std::lower_bound(inserted.begin(), inserted.end(), first);
+    auto eraseIt = std::lower_bound(erased.begin(), erased.end(), first);
+    while (true) {
+        // Next entry in time order from the merge of run and insert buffer
+        bool fromRun;
+        if (runIt != run.end() && (insertIt == inserted.end() || !(*insertIt < *runIt))) {
+            fromRun = true;
+        } else if (insertIt != inserted.end()) {
+            fromRun = false;
+        } else {
+            return;
+        }
+        const Entry& entry = fromRun ? *runIt : *insertIt;
+        if (entry.time > to) {
+            return;
+        }
+        if (fromRun) ++runIt; else ++insertIt;
+
+        // Skip it if an erase cancels it
+        while (eraseIt != erased.end() && *eraseIt < entry) ++eraseIt;
+        if (eraseIt != erased.end() && *eraseIt == entry) {
+            ++eraseIt;
+            continue;
+        }
+        if (!visit(entry.slot)) {
+            return;
+        }
+    }
+}
+
+#endif // TASK_TIME_INDEX_H
@@ -0,0 +1,134 @@
+#ifndef TASK_VIEW_H
+#define TASK_VIEW_H
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include "Task.h"
+
+// TaskView is a lightweight, non-owning window over tasks stored somewhere else (usually a TodoList).
+// It never copies a Task: iterating it hands out const references straight into the owner's storage.
+// It works in one of two modes:
+//  - scan mode walks every slot, skipping tombstones (ID 0) and tasks that don't match a status filter
+//  - index mode walks a list of slot numbers the owner already filtered, so it only touches matches
+// A view is invalidated by any call that adds, removes, completes or replaces tasks in its owner.
+class TaskView : public std::ranges::view_interface<TaskView> {
+public:
+    // Which tasks the view lets through
+    enum class Filter { All, Completed, Pending };
+
+    // Forward iterator over the visible tasks
+    class Iterator {
+    private:
+        const Task* current;          // Scan mode: task the iterator points at
+        const Task* last;             // Scan mode: one past the final slot of the storage
+        const Task* base;             // Index mode: first slot of the storage
+        const std::size_t* slot;      // Index mode: current entry of the slot list (nullptr in scan mode)
+        Filter filter;                // Scan mode: status filter shared with the parent view
+
+        // True if the task at current should be visited
+        bool accepts() const {
+            if (current->getId() == 0) return false; // Tombstone left behind by a removal
+            if (filter == Filter::Completed) return current->isCompleted();
+            if (filter == Filter::Pending) return !current->isCompleted();
+            return true;
+        }
+
+        // Moves forward until an accepted task (or the end) is reached
+        void skipRejected() {
+            while (current != last && !accepts()) {
+                ++current;
+            }
+        }
+
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Task;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Task*;
+        using reference = const Task&;
+
+        Iterator() : current(nullptr), last(nullptr), base(nullptr), slot(nullptr), filter(Filter::All) {}
+
+        // Scan mode
+        Iterator(const Task* current, const Task* last, Filter filter)
+            : current(current), last(last), base(nullptr), slot(nullptr), filter(filter) {
+            skipRejected();
+        }
+
+        // Index mode
+        Iterator(const Task* base, const std::size_t* slot)
+            : current(nullptr), last(nullptr), base(base), slot(slot), filter(Filter::All) {}
+
+        reference operator*() const { return slot ? base[*slot] : *current; }
+        pointer operator->() const { return &**this; }
+
+        Iterator& operator++() {
+            if (slot) {
+                ++slot;
+            } else {
+                ++current;
+                skipRejected();
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return current == other.current && slot == other.slot;
+        }
+    };
+
+    // Sentinel value meaning "count not known yet, work it out when asked"
+    static constexpr std::size_t unknownCount = static_cast<std::size_t>(-1);
+
+    TaskView() : first(nullptr), last(nullptr), firstSlot(nullptr), lastSlot(nullptr),
+                 indexed(false), filter(Filter::All), count(0) {}
+
+    // Scan mode: views a plain block of tasks; count can be passed in when the owner already knows it
+    TaskView(std::span<const Task> tasks, Filter filter = Filter::All, std::size_t count = unknownCount)
+        : first(tasks.data()), last(tasks.data() + tasks.size()), firstSlot(nullptr), lastSlot(nullptr),
+          indexed(false), filter(filter), count(count) {}
+
+    // Index mode: views exactly the tasks at the given slots, in the order listed
+    TaskView(std::span<const Task> tasks, std::span<const std::size_t> slots)
+        : first(tasks.data()), last(tasks.data() + tasks.size()),
+          firstSlot(slots.data()), lastSlot(slots.data() + slots.size()),
+          indexed(true), filter(Filter::All), count(slots.size()) {}
+
+    Iterator begin() const {
+        return indexed ? Iterator(first, firstSlot) : Iterator(first, last, filter);
+    }
+
+    Iterator end() const {
+        return indexed ? Iterator(first, lastSlot) : Iterator(last, last, filter);
+    }
+
+    // Number of tasks the view yields (walks the storage only if the owner didn't supply it)
+    std::size_t size() const {
+        if (count == unknownCount) {
+            count = static_cast<std::size_t>(std::distance(begin(), end()));
+        }
+        return count;
+    }
+
+    bool empty() const { return count == unknownCount ? begin() == end() : count == 0; }
+
+private:
+    const Task* first;             // First slot of the underlying storage
+    const Task* last;              // One past the last slot
+    const std::size_t* firstSlot;  // Index mode: first entry of the slot list
+    const std::size_t* lastSlot;   // Index mode: one past the last entry of the slot list
+    bool indexed;                  // True in index mode
+    Filter filter;                 // Status filter applied while iterating in scan mode
+    mutable std::size_t count;     // Cached number of visible tasks (unknownCount until computed)
+};
+
+#endif // TASK_VIEW_H
\ No newline at end of file
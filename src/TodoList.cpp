@@ -1,101 +1,736 @@
 #include "TodoList.h"
+#include "Metrics.h"
 #include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+namespace {
+
+// Re-checks the word part of a query against a description (for slots whose indexed words may be stale)
+bool matchesWords(const TaskQuery& query, std::string_view description,
+                  const std::vector<std::string>& terms, const std::vector<std::string>& prefixes) {
+    bool any = false;
+    bool all = true;
+    for (const std::string& term : terms) {
+        bool found = TaskSearchIndex::hasWord(description, term);
+        any = any || found;
+        all = all && found;
+    }
+    for (const std::string& start : prefixes) {
+        bool found = TaskSearchIndex::hasPrefix(description, start);
+        any = any || found;
+        all = all && found;
+    }
+    return query.mode == TaskQuery::Mode::All ? all : any;
+}
+
+// Checkpoint tokens are drawn from one counter, so a token taken on one list never matches another
+std::atomic<std::uint64_t> nextCheckpoint{1};
+
+// Makes room for extra more elements. Growing to exactly what a batch needs would reallocate on every
+// call, so capacity still at least doubles.
+template <typename Vector>
+void reserveExtra(Vector& vector, std::size_t extra) {
+    std::size_t needed = vector.size() + extra;
+    if (needed > vector.capacity()) {
+        vector.reserve(std::max(needed, vector.capacity() * 2));
+    }
+}
+
+} // namespace
+
+// Every container draws from the same arena, so their nodes and buffers are freed with it
+TodoList::Storage::Storage(std::pmr::memory_resource* arena)
+    : tasks(arena), slotById(arena), statusSlots{std::pmr::vector<std::size_t>(arena),
+                                                 std::pmr::vector<std::size_t>(arena)} {}
+
+void* TodoList::CountingResource::do_allocate(std::size_t size, std::size_t alignment) {
+    void* pointer = std::pmr::new_delete_resource()->allocate(size, alignment);
+    bytes += size;
+    return pointer;
+}
+
+void TodoList::CountingResource::do_deallocate(void* pointer, std::size_t size, std::size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(pointer, size, alignment);
+    bytes -= size;
+}
 
 // Constructor: Start task IDs at 1
-TodoList::TodoList() : nextTaskId(1) {}
+TodoList::TodoList() : storage(nullptr), tombstoneCount(0), nextTaskId(1),
+                       staleEntries{0, 0}, statusSorted{true, true}, statusCount{0, 0},
+                       observer(nullptr), generation(0), checkpoint(0), firstChangedSlot(0),
+                       searchIndexBuilt(false), timeIndexBuilt(false) {
+    resetStorage();
+}
 
-// Adds a new task with a unique ID
+// The old Storage is deliberately not destroyed: its destructors would only hand memory back to the
+// old arena one node at a time, and destroying the arena returns all of it at once
+void TodoList::resetStorage() {
+    auto freshArena = std::make_unique<std::pmr::unsynchronized_pool_resource>(&arenaUpstream);
+    void* memory = freshArena->allocate(sizeof(Storage), alignof(Storage));
+    storage = new (memory) Storage(freshArena.get());
+    arena = std::move(freshArena);
+}
+
+// Adds a new task with a unique ID, constructed in place in the arena
 void TodoList::addTask(const std::string& description) {
-    Task newTask(nextTaskId, description);
-    tasks.push_back(newTask);
+    TODO_METRICS_TIME(Add);
+    storage->tasks.emplace_back(nextTaskId, description);
+    storage->slotById[nextTaskId] = storage->tasks.size() - 1;
+
+    // New tasks start pending and always land in the last slot, so the pending list stays sorted
+    storage->statusSlots[0].push_back(storage->tasks.size() - 1);
+    statusCount[0]++;
+
+    if (searchIndexBuilt) {
+        searchIndex.add(storage->tasks.size() - 1, description);
+    }
+    updateTimeIndex(storage->tasks.size() - 1, {}, timeStateOf(storage->tasks.back()));
+
     nextTaskId++; // Prepare for the next task
+    generation++;
+    noteChangedSlot(storage->tasks.size() - 1);
+
+    if (observer) {
+        observer->onTaskAdded(storage->tasks.back());
+    }
+}
+
+// Inserts or overwrites a task with its stored ID and fields
+void TodoList::upsertTask(const Task& task) {
+    auto it = storage->slotById.find(task.getId());
+
+    if (it != storage->slotById.end()) {
+        Task& existing = storage->tasks[it->second];
+        bool wasCompleted = existing.isCompleted();
+        if (searchIndexBuilt && existing.getDescription() != task.getDescription()) {
+            searchIndex.markChanged(it->second);
+            searchIndex.add(it->second, task.getDescription());
+        }
+        updateTimeIndex(it->second, timeStateOf(existing), timeStateOf(task));
+        noteChangedSlot(it->second);
+        existing = task;
+        changeStatus(it->second, wasCompleted, task.isCompleted());
+    } else {
+        storage->tasks.push_back(task);
+        std::size_t slot = storage->tasks.size() - 1;
+        storage->slotById[task.getId()] = slot;
+        noteChangedSlot(slot);
+
+        int status = task.isCompleted() ? 1 : 0;
+        storage->statusSlots[status].push_back(slot);
+        statusCount[status]++;
+
+        if (searchIndexBuilt) {
+            searchIndex.add(slot, task.getDescription());
+        }
+        updateTimeIndex(slot, {}, timeStateOf(task));
+
+        if (task.getId() >= nextTaskId) {
+            nextTaskId = task.getId() + 1;
+        }
+    }
+    generation++;
+
+    if (observer) {
+        observer->onTaskAdded(task);
+    }
+}
+
+// Validates every description first, so a bad one leaves the list untouched
+int TodoList::addTasks(std::span<const std::string> descriptions) {
+    for (const std::string& description : descriptions) {
+        if (description.empty()) {
+            throw std::invalid_argument("Task description cannot be empty");
+        }
+    }
+
+    reserveExtra(storage->tasks, descriptions.size());
+    reserveExtra(storage->statusSlots[0], descriptions.size());
+    std::size_t neededIds = storage->slotById.size() + descriptions.size();
+    if (neededIds > storage->slotById.bucket_count() * storage->slotById.max_load_factor()) {
+        storage->slotById.reserve(std::max(neededIds, storage->slotById.size() * 2));
+    }
+
+    int firstId = nextTaskId;
+    noteChangedSlot(storage->tasks.size());
+    time_t now = time(nullptr);
+    for (const std::string& description : descriptions) {
+        std::size_t slot = storage->tasks.size();
+        storage->tasks.emplace_back(nextTaskId, description, false, now, 0);
+        storage->slotById[nextTaskId] = slot;
+
+        // Appended in slot order, like addTask, so the pending list stays sorted
+        storage->statusSlots[0].push_back(slot);
+        statusCount[0]++;
+
+        if (searchIndexBuilt) {
+            searchIndex.add(slot, description);
+        }
+        updateTimeIndex(slot, {}, timeStateOf(storage->tasks.back()));
+
+        nextTaskId++;
+        generation++;
+        if (observer) {
+            observer->onTaskAdded(storage->tasks.back());
+        }
+    }
+    return firstId;
 }
 
 // Removes a task by ID if it exists
 bool TodoList::removeTask(int id) {
-    auto it = std::find_if(tasks.begin(), tasks.end(),
-        [id](const Task& task) { return task.getId() == id; });
+    TODO_METRICS_TIME(Remove);
+    auto it = storage->slotById.find(id);
+    if (it == storage->slotById.end()) {
+        return false;
+    }
 
-    if (it != tasks.end()) {
-        tasks.erase(it);
-        return true;
+    retireSlot(it->second);
+    compactIfNeeded();
+    return true;
+}
+
+// The IDs are resolved to slots first and retired in list order, so the tasks (and their arena memory) are
+// walked front to back rather than in whatever order the IDs came in; the slots are squeezed at most once
+std::size_t TodoList::removeTasks(std::span<const int> ids) {
+    std::vector<std::size_t> slots;
+    slots.reserve(ids.size());
+    for (int id : ids) {
+        auto it = storage->slotById.find(id);
+        if (it != storage->slotById.end()) {
+            slots.push_back(it->second);
+        }
+    }
+    std::sort(slots.begin(), slots.end());
+    slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+
+    prepareBulkRemoval(slots.size());
+    for (std::size_t slot : slots) {
+        retireSlot(slot);
+    }
+    compactIfNeeded();
+    return slots.size();
+}
+
+void TodoList::retireSlot(std::size_t slot) {
+    Task& task = storage->tasks[slot];
+    int id = task.getId();
+
+    // Its entry in the status list is now stale
+    int status = task.isCompleted() ? 1 : 0;
+    statusCount[status]--;
+    staleEntries[status]++;
+
+    updateTimeIndex(slot, timeStateOf(task), {});
+
+    // Leave a tombstone instead of erasing, so later slots don't have to shift
+    task = Task();
+    storage->slotById.erase(id);
+    tombstoneCount++;
+    generation++;
+    noteChangedSlot(slot);
+
+    if (observer) {
+        observer->onTaskRemoved(id);
     }
+}
 
-    return false;
+// Each erased entry costs a lookup in three indexes, while a rebuild is one pass over the live tasks
+void TodoList::prepareBulkRemoval(std::size_t count) {
+    if (timeIndexBuilt && count * 4 >= storage->tasks.size() - tombstoneCount) {
+        createdIndex.clear();
+        pendingIndex.clear();
+        completedIndex.clear();
+        timeIndexBuilt = false;
+    }
 }
 
 // Marks a task as completed based on its ID
 bool TodoList::markTaskAsCompleted(int id) {
-    for (auto& task : tasks) {
-        if (task.getId() == id) {
-            task.markAsCompleted();
-            return true;
+    TODO_METRICS_TIME(Complete);
+    auto it = storage->slotById.find(id);
+    if (it == storage->slotById.end()) {
+        return false;
+    }
+
+    completeSlot(it->second);
+    return true;
+}
+
+std::size_t TodoList::completeTasks(std::span<const int> ids) {
+    reserveExtra(storage->statusSlots[1], ids.size());
+    std::size_t completed = 0;
+    for (int id : ids) {
+        auto it = storage->slotById.find(id);
+        if (it != storage->slotById.end()) {
+            completeSlot(it->second);
+            completed++;
         }
     }
-    return false;
+    return completed;
+}
+
+void TodoList::completeSlot(std::size_t slot) {
+    Task& task = storage->tasks[slot];
+
+    // Completing twice just refreshes the timestamp
+    bool wasCompleted = task.isCompleted();
+    TimeState before = timeStateOf(task);
+    task.markAsCompleted();
+    changeStatus(slot, wasCompleted, true);
+    updateTimeIndex(slot, before, timeStateOf(task));
+    generation++;
+    noteChangedSlot(slot);
+
+    if (observer) {
+        observer->onTaskCompleted(task);
+    }
+}
+
+// Retires the slot's entry in its old status list and appends it to the new one
+void TodoList::changeStatus(std::size_t slot, bool wasCompleted, bool isCompleted) {
+    if (wasCompleted == isCompleted) {
+        return;
+    }
+
+    int from = wasCompleted ? 1 : 0;
+    int to = isCompleted ? 1 : 0;
+    statusCount[from]--;
+    staleEntries[from]++;
+
+    // ">=" because a task flipped back and forth (via upsertTask) may still have an old entry here
+    std::pmr::vector<std::size_t>& slots = storage->statusSlots[to];
+    if (!slots.empty() && slots.back() >= slot) {
+        statusSorted[to] = false;
+    }
+    slots.push_back(slot);
+    statusCount[to]++;
 }
 
 // Returns a copy of all tasks
 std::vector<Task> TodoList::getAllTasks() const {
-    return tasks;
+    std::vector<Task> allTasks;
+    allTasks.reserve(storage->tasks.size() - tombstoneCount);
+
+    for (const auto& task : storage->tasks) {
+        if (!isTombstone(task)) {
+            allTasks.push_back(task);
+        }
+    }
+
+    return allTasks;
+}
+
+// Views over the live slots; none of these copy a Task
+TaskView TodoList::viewAllTasks() const {
+    return TaskView(storage->tasks, TaskView::Filter::All, storage->tasks.size() - tombstoneCount);
+}
+
+TaskView TodoList::viewCompletedTasks() const {
+    return TaskView(storage->tasks, cleanStatusSlots(true));
+}
+
+TaskView TodoList::viewPendingTasks() const {
+    return TaskView(storage->tasks, cleanStatusSlots(false));
+}
+
+void TodoList::ensureSearchIndex() const {
+    if (searchIndexBuilt) {
+        return;
+    }
+    searchIndex.clear();
+    for (std::size_t slot = 0; slot < storage->tasks.size(); slot++) {
+        if (!isTombstone(storage->tasks[slot])) {
+            searchIndex.add(slot, storage->tasks[slot].getDescription());
+        }
+    }
+    searchIndexBuilt = true;
+}
+
+void TodoList::dropQueryIndexes() {
+    searchIndex.clear();
+    searchIndexBuilt = false;
+    createdIndex.clear();
+    pendingIndex.clear();
+    completedIndex.clear();
+    timeIndexBuilt = false;
+}
+
+void TodoList::ensureTimeIndex() const {
+    if (timeIndexBuilt) {
+        return;
+    }
+
+    std::vector<TaskTimeIndex::Entry> created, pending, completed;
+    created.reserve(storage->tasks.size() - tombstoneCount);
+    for (std::size_t slot = 0; slot < storage->tasks.size(); slot++) {
+        const Task& task = storage->tasks[slot];
+        if (isTombstone(task)) continue;
+        created.push_back({task.getCreationDate(), slot});
+        if (task.isCompleted()) {
+            completed.push_back({task.getCompletionDate(), slot});
+        } else {
+            pending.push_back({task.getCreationDate(), slot});
+        }
+    }
+    createdIndex.assign(std::move(created));
+    pendingIndex.assign(std::move(pending));
+    completedIndex.assign(std::move(completed));
+    timeIndexBuilt = true;
+}
+
+// Each index holds at most one entry per slot; it's only touched if that entry actually changes
+void TodoList::updateTimeIndex(std::size_t slot, const TimeState& before, const TimeState& after) {
+    if (!timeIndexBuilt) {
+        return;
+    }
+
+    auto move = [slot](TaskTimeIndex& index, bool hadEntry, time_t oldTime, bool hasEntry, time_t newTime) {
+        if (hadEntry && hasEntry && oldTime == newTime) return;
+        if (hadEntry) index.erase(oldTime, slot);
+        if (hasEntry) index.insert(newTime, slot);
+    };
+    move(createdIndex, before.live, before.creationDate, after.live, after.creationDate);
+    move(pendingIndex, before.live && !before.completed, before.creationDate,
+         after.live && !after.completed, after.creationDate);
+    move(completedIndex, before.live && before.completed, before.completionDate,
+         after.live && after.completed, after.completionDate);
+}
+
+TaskView TodoList::createdBetween(time_t from, time_t to) const {
+    ensureTimeIndex();
+    queryResults.clear();
+    createdIndex.forEachBetween(from, to, [this](std::size_t slot) {
+        queryResults.push_back(slot);
+        return true;
+    });
+    return TaskView(storage->tasks, queryResults);
+}
+
+TaskView TodoList::completedBetween(time_t from, time_t to) const {
+    ensureTimeIndex();
+    queryResults.clear();
+    completedIndex.forEachBetween(from, to, [this](std::size_t slot) {
+        queryResults.push_back(slot);
+        return true;
+    });
+    return TaskView(storage->tasks, queryResults);
+}
+
+TaskView TodoList::oldestPending(std::size_t count) const {
+    ensureTimeIndex();
+    queryResults.clear();
+    if (count > 0) {
+        pendingIndex.forEachBetween(std::numeric_limits<time_t>::min(), std::numeric_limits<time_t>::max(),
+                                    [this, count](std::size_t slot) {
+            queryResults.push_back(slot);
+            return queryResults.size() < count;
+        });
+    }
+    return TaskView(storage->tasks, queryResults);
+}
+
+std::vector<DayCount> TodoList::createdPerDay(time_t from, time_t to) const {
+    ensureTimeIndex();
+    return countPerDay(createdIndex, from, to);
+}
+
+std::vector<DayCount> TodoList::completedPerDay(time_t from, time_t to) const {
+    ensureTimeIndex();
+    return countPerDay(completedIndex, from, to);
+}
+
+// Two rank lookups per day; mktime normalizes "day + 1", so DST changes and month ends just work
+std::vector<DayCount> TodoList::countPerDay(const TaskTimeIndex& index, time_t from, time_t to) {
+    std::vector<DayCount> days;
+    if (to < from) {
+        return days;
+    }
+
+    std::tm day{};
+    localtime_r(&from, &day);
+    day.tm_hour = 0;
+    day.tm_min = 0;
+    day.tm_sec = 0;
+    day.tm_isdst = -1;
+    time_t dayStart = std::mktime(&day);
+
+    while (dayStart <= to) {
+        day.tm_mday++;
+        day.tm_isdst = -1;
+        time_t nextStart = std::mktime(&day);
+        if (nextStart <= dayStart) {
+            break; // mktime failed (out of range)
+        }
+        days.push_back({dayStart, index.countBetween(dayStart, nextStart)});
+        dayStart = nextStart;
+    }
+    return days;
+}
+
+// Candidates come from the index (or every slot of the wanted status); each one is then checked for
+// tombstones, status, the raw substring and, if its words changed since indexing, the words themselves
+TaskView TodoList::search(const TaskQuery& query) const {
+    queryResults.clear();
+    const auto& tasks = storage->tasks;
+    if (query.matchesNothing) {
+        return TaskView(tasks, queryResults);
+    }
+
+    // Query words are matched in the same normalized form the index stores
+    std::vector<std::string> terms, prefixes;
+    for (const std::string& term : query.terms) terms.push_back(TaskSearchIndex::normalize(term));
+    for (const std::string& start : query.prefixes) prefixes.push_back(TaskSearchIndex::normalize(start));
+    bool usesIndex = !terms.empty() || !prefixes.empty();
+
+    auto accept = [&](std::size_t slot) {
+        const Task& task = tasks[slot];
+        if (isTombstone(task)) return;
+        if (query.status == TaskView::Filter::Completed && !task.isCompleted()) return;
+        if (query.status == TaskView::Filter::Pending && task.isCompleted()) return;
+        if (!TaskSearchIndex::containsSubstring(task.getDescription(), query.substring)) return;
+        if (usesIndex && searchIndex.isChanged(slot) && !matchesWords(query, task.getDescription(), terms, prefixes)) return;
+        queryResults.push_back(slot);
+    };
+
+    if (!usesIndex) {
+        // Nothing to look up: scan, letting the status lists narrow the slots down when they can
+        if (query.status == TaskView::Filter::All) {
+            for (std::size_t slot = 0; slot < tasks.size(); slot++) accept(slot);
+        } else {
+            for (std::size_t slot : cleanStatusSlots(query.status == TaskView::Filter::Completed)) accept(slot);
+        }
+        return TaskView(tasks, queryResults);
+    }
+
+    ensureSearchIndex();
+
+    // One sorted slot list per word or prefix
+    std::vector<std::vector<std::uint32_t>> lists;
+    for (const std::string& term : terms) lists.push_back(searchIndex.term(term));
+    for (const std::string& start : prefixes) lists.push_back(searchIndex.prefix(start));
+
+    std::vector<std::uint32_t> candidates, scratch;
+    if (query.mode == TaskQuery::Mode::All) {
+        // Intersect smallest first, so the working set only shrinks
+        std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) { return a.size() < b.size(); });
+        candidates = std::move(lists.front());
+        for (std::size_t i = 1; i < lists.size() && !candidates.empty(); i++) {
+            scratch.clear();
+            std::set_intersection(candidates.begin(), candidates.end(), lists[i].begin(), lists[i].end(),
+                                  std::back_inserter(scratch));
+            candidates.swap(scratch);
+        }
+    } else {
+        for (const auto& list : lists) {
+            scratch.clear();
+            std::set_union(candidates.begin(), candidates.end(), list.begin(), list.end(), std::back_inserter(scratch));
+            candidates.swap(scratch);
+        }
+    }
+
+    queryResults.reserve(candidates.size());
+    for (std::uint32_t slot : candidates) {
+        accept(slot);
+    }
+    return TaskView(tasks, queryResults);
+}
+
+// Columnar copy of the list: one pass over the live slots
+TaskStore TodoList::buildTaskStore() const {
+    TaskStore store;
+    store.reserve(storage->tasks.size() - tombstoneCount);
+    for (const Task& task : viewAllTasks()) {
+        store.append(task);
+    }
+    return store;
 }
 
 // Finds a task by ID and returns a pointer to it (nullptr if not found)
 Task* TodoList::getTaskById(int id) {
-    for (auto& task : tasks) {
-        if (task.getId() == id) {
-            return &task;
-        }
+    TODO_METRICS_TIME(Lookup);
+    auto it = storage->slotById.find(id);
+    if (it != storage->slotById.end()) {
+        return &storage->tasks[it->second];
     }
     return nullptr;
 }
 
 // Clears every task from the list and resets the ID counter
 void TodoList::clearAllTasks() {
-    tasks.clear();
+    resetStorage();
+    tombstoneCount = 0;
     nextTaskId = 1;
+    rebuildStatusIndex();
+    dropQueryIndexes();
+    generation++;
+    noteChangedSlot(0);
+
+    if (observer) {
+        observer->onTasksCleared();
+    }
+}
+
+std::uint64_t TodoList::markCheckpoint() {
+    checkpoint = nextCheckpoint.fetch_add(1, std::memory_order_relaxed);
+    firstChangedSlot = static_cast<std::size_t>(-1);
+    return checkpoint;
+}
+
+std::size_t TodoList::firstSlotChangedSince(std::uint64_t token) const {
+    if (token == 0 || token != checkpoint) {
+        return 0;
+    }
+    return std::min(firstChangedSlot, storage->tasks.size());
+}
+
+void TodoList::setObserver(TodoListObserver* observer) {
+    this->observer = observer;
 }
 
 // Returns how many tasks are currently in the list
 int TodoList::getTaskCount() const {
-    return tasks.size();
+    return storage->tasks.size() - tombstoneCount;
 }
 
-// Returns only the completed tasks
-std::vector<Task> TodoList::getCompletedTasks() const {
-    std::vector<Task> completedTasks;
+// Status counts are maintained on every mutation, so these never scan
+int TodoList::getCompletedCount() const {
+    return statusCount[1];
+}
 
-    for (const auto& task : tasks) {
-        if (task.isCompleted()) {
-            completedTasks.push_back(task);
-        }
-    }
+int TodoList::getPendingCount() const {
+    return statusCount[0];
+}
 
-    return completedTasks;
+// Returns only the completed tasks
+std::vector<Task> TodoList::getCompletedTasks() const {
+    TaskView completed = viewCompletedTasks();
+    return std::vector<Task>(completed.begin(), completed.end());
 }
 
 // Returns tasks that haven't been completed yet
 std::vector<Task> TodoList::getPendingTasks() const {
-    std::vector<Task> pendingTasks;
-
-    for (const auto& task : tasks) {
-        if (!task.isCompleted()) {
-            pendingTasks.push_back(task);
-        }
-    }
-
-    return pendingTasks;
+    TaskView pending = viewPendingTasks();
+    return std::vector<Task>(pending.begin(), pending.end());
 }
 
 // Loads a list of tasks (e.g. from file) and updates the nextTaskId
 void TodoList::setTasks(const std::vector<Task>& tasks) {
-    this->tasks = tasks;
+    resetStorage();
+    storage->tasks.assign(tasks.begin(), tasks.end());
+    reindex();
+}
+
+// Builds each task in place from its record: the only allocations are arena blocks
+void TodoList::setTasks(std::span<const TaskRecord> records) {
+    resetStorage();
+    storage->tasks.reserve(records.size());
+    for (const TaskRecord& record : records) {
+        storage->tasks.emplace_back(record);
+    }
+    reindex();
+}
+
+// Rebuilds the ID index from scratch after the task vector was replaced
+void TodoList::reindex() {
+    storage->slotById.clear();
+    storage->slotById.reserve(storage->tasks.size());
+    tombstoneCount = 0;
+    generation++;  // Every setTasks ends up here
+    noteChangedSlot(0);
 
     // Make sure future task IDs are unique
     nextTaskId = 1;
-    for (const auto& task : tasks) {
-        if (task.getId() >= nextTaskId) {
-            nextTaskId = task.getId() + 1;
+    for (std::size_t slot = 0; slot < storage->tasks.size(); slot++) {
+        int id = storage->tasks[slot].getId();
+
+        // Only the first task with a given ID is reachable; later duplicates become tombstones
+        if (!storage->slotById.emplace(id, slot).second) {
+            storage->tasks[slot] = Task();
+            tombstoneCount++;
+            continue;
+        }
+
+        if (id >= nextTaskId) {
+            nextTaskId = id + 1;
         }
     }
+
+    compactIfNeeded();
+    rebuildStatusIndex();
+    dropQueryIndexes();
+}
+
+// Compacts only when at least half of the slots are dead, so each remove pays O(1) amortized
+void TodoList::compactIfNeeded() {
+    if (tombstoneCount > 0 && tombstoneCount * 2 >= storage->tasks.size()) {
+        compact();
+    }
+}
+
+// Stable compaction: live tasks keep their relative order (and those before the first tombstone stay put)
+void TodoList::compact() {
+    auto firstTombstone = std::find_if(storage->tasks.begin(), storage->tasks.end(),
+        [](const Task& task) { return isTombstone(task); });
+    std::size_t firstMoved = static_cast<std::size_t>(firstTombstone - storage->tasks.begin());
+    noteChangedSlot(firstMoved);
+
+    auto newEnd = std::remove_if(firstTombstone, storage->tasks.end(),
+        [](const Task& task) { return isTombstone(task); });
+    storage->tasks.erase(newEnd, storage->tasks.end());
+    tombstoneCount = 0;
+
+    // Slots moved, so point every ID from the first tombstone on at its new position
+    for (std::size_t slot = firstMoved; slot < storage->tasks.size(); slot++) {
+        storage->slotById[storage->tasks[slot].getId()] = slot;
+    }
+    rebuildStatusIndex();
+    dropQueryIndexes();
+}
+
+// One pass over the slots refills both status lists in slot order
+void TodoList::rebuildStatusIndex() {
+    for (int status = 0; status < 2; status++) {
+        storage->statusSlots[status].clear();
+        staleEntries[status] = 0;
+        statusSorted[status] = true;
+        statusCount[status] = 0;
+    }
+
+    for (std::size_t slot = 0; slot < storage->tasks.size(); slot++) {
+        if (!isTombstone(storage->tasks[slot])) {
+            int status = storage->tasks[slot].isCompleted() ? 1 : 0;
+            storage->statusSlots[status].push_back(slot);
+            statusCount[status]++;
+        }
+    }
+}
+
+// Each stale entry is dropped exactly once, so the purge is paid for by the mutation that created it
+const std::pmr::vector<std::size_t>& TodoList::cleanStatusSlots(bool completed) const {
+    int status = completed ? 1 : 0;
+    std::pmr::vector<std::size_t>& slots = storage->statusSlots[status];
+
+    if (staleEntries[status] > 0) {
+        auto newEnd = std::remove_if(slots.begin(), slots.end(), [this, completed](std::size_t slot) {
+            return isTombstone(storage->tasks[slot]) || storage->tasks[slot].isCompleted() != completed;
+        });
+        slots.erase(newEnd, slots.end());
+        staleEntries[status] = 0;
+    }
+
+    // Completions append in completion order; sort back into list order (costs O(k log k) in the output)
+    // and drop any duplicate entry left by a task whose status flipped back and forth
+    if (!statusSorted[status]) {
+        std::sort(slots.begin(), slots.end());
+        slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+        statusSorted[status] = true;
+    }
+
+    return slots;
 }
\ No newline at end of file
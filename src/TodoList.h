@@ -2,17 +2,150 @@
 #define TODOLIST_H
 
 #include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <span>
 #include "Task.h"
+#include "TaskView.h"
+#include "TaskStore.h"
+#include "TaskSearchIndex.h"
+#include "TaskTimeIndex.h"
+#include "TodoListObserver.h"
 
 class TodoList {
 private:
-    std::vector<Task> tasks;     // Stores all the tasks in the list
+    // Every container of the list, allocated (along with every description) from the list's arena
+    struct Storage {
+        explicit Storage(std::pmr::memory_resource* arena);
+
+        std::pmr::vector<Task> tasks;  // Stores all the tasks in insertion order (removed ones leave a tombstone slot)
+        std::pmr::unordered_map<int, std::size_t> slotById; // Maps a task ID to its slot in tasks for O(1) lookups
+
+        // Per-status slot lists ([0] = pending, [1] = completed) so status listings only touch matching tasks.
+        // Completing or removing a task doesn't erase its old entry; it just goes stale and is purged lazily
+        // the next time that list is read, which keeps every mutation O(1).
+        std::pmr::vector<std::size_t> statusSlots[2];
+    };
+
+    // Upstream of the arena: passes through to the heap and keeps a running total of what the arena holds
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        std::size_t bytes = 0;
+
+    private:
+        void* do_allocate(std::size_t size, std::size_t alignment) override;
+        void do_deallocate(void* pointer, std::size_t size, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+    CountingResource arenaUpstream;  // Declared before arena so it outlives every pool that draws from it
+
+    // Pool that owns all of the list's memory. Storage lives inside it and is never destroyed on its own:
+    // dropping the arena frees every task, string and index node at once, in time independent of their number.
+    std::unique_ptr<std::pmr::unsynchronized_pool_resource> arena;
+    Storage* storage;            // Placement-constructed in arena (status lists are purged from const readers)
+
+    std::size_t tombstoneCount;  // How many slots in tasks are tombstones waiting for compaction
     int nextTaskId;              // Keeps track of the next available ID to assign
 
+    mutable std::size_t staleEntries[2];  // How many entries in each status list no longer match
+    mutable bool statusSorted[2];         // False once entries were appended out of slot order
+    std::size_t statusCount[2];           // Exact number of live pending / completed tasks
+
+    TodoListObserver* observer;  // Told about every mutation (nullptr if nobody is listening)
+    std::uint64_t generation;    // Bumped by every change to the tasks (see getGeneration)
+    std::uint64_t checkpoint;    // Token of the latest markCheckpoint (0 = none yet)
+    std::size_t firstChangedSlot;// Lowest slot changed or moved since that checkpoint
+
+    // Word index over descriptions. It's only built by the first search (so loads don't pay for it), then
+    // kept current by add/upsert; anything that moves slots around just drops it until the next search.
+    mutable TaskSearchIndex searchIndex;
+    mutable bool searchIndexBuilt;
+
+    // Ordered timestamp indexes, built by the first time query and then kept current by every mutation
+    // (and dropped, like the search index, when slots move)
+    mutable TaskTimeIndex createdIndex;    // Every live task, by creation date
+    mutable TaskTimeIndex pendingIndex;    // Pending tasks only, by creation date
+    mutable TaskTimeIndex completedIndex;  // Completed tasks only, by completion date
+    mutable bool timeIndexBuilt;
+
+    mutable std::vector<std::size_t> queryResults; // Slots matched by the last search or time query (what its view walks)
+
+    // Tombstones are default-constructed tasks, which always have ID 0
+    static bool isTombstone(const Task& task) { return task.getId() == 0; }
+
+    // Swaps in a fresh, empty arena and Storage, releasing the old ones wholesale
+    void resetStorage();
+
+    // Rebuilds slotById and nextTaskId after tasks has been replaced wholesale
+    void reindex();
+
+    // Rebuilds both status lists from scratch (after a reindex or compaction moved slots)
+    void rebuildStatusIndex();
+
+    // Purges stale entries and restores slot order for one status list, then returns it
+    const std::pmr::vector<std::size_t>& cleanStatusSlots(bool completed) const;
+
+    // Squeezes out tombstones once they make up half of the slots (keeps removes amortized O(1))
+    void compactIfNeeded();
+
+    // Drops every tombstone while keeping the order of live tasks, then rebuilds slotById
+    void compact();
+
+    // Indexes every live task if the search index isn't built yet
+    void ensureSearchIndex() const;
+
+    // Forgets the search and time indexes after slots moved (they're rebuilt by the next query)
+    void dropQueryIndexes();
+
+    // Indexes every live task's timestamps if the time indexes aren't built yet
+    void ensureTimeIndex() const;
+
+    // The fields of a task the time indexes care about (captured before a mutation changes them)
+    struct TimeState {
+        bool live = false;           // False for "no task here"
+        bool completed = false;
+        time_t creationDate = 0;
+        time_t completionDate = 0;
+    };
+    static TimeState timeStateOf(const Task& task) {
+        return {true, task.isCompleted(), task.getCreationDate(), task.getCompletionDate()};
+    }
+
+    // Moves a slot's time index entries from the task's old state to its new one
+    void updateTimeIndex(std::size_t slot, const TimeState& before, const TimeState& after);
+
+    // Counts one index per local calendar day
+    static std::vector<DayCount> countPerDay(const TaskTimeIndex& index, time_t from, time_t to);
+
+    // Lowers firstChangedSlot to slot
+    void noteChangedSlot(std::size_t slot) {
+        if (slot < firstChangedSlot) firstChangedSlot = slot;
+    }
+
+    // Moves a slot's entry between the status lists after its task changed status
+    void changeStatus(std::size_t slot, bool wasCompleted, bool isCompleted);
+
+    // Marks the slot's task as completed and tells the observer
+    void completeSlot(std::size_t slot);
+
+    // Turns a live slot into a tombstone and tells the observer (compaction is left to the caller)
+    void retireSlot(std::size_t slot);
+
+    // Before removing count tasks at once: drops the time indexes if erasing that many entries one by one
+    // would cost more than rebuilding them on the next time query
+    void prepareBulkRemoval(std::size_t count);
+
 public:
     // Constructor
     TodoList();  // Sets up the to-do list (likely sets nextTaskId to 1 or 0)
 
+    // The arena is owned by exactly one list
+    TodoList(const TodoList&) = delete;
+    TodoList& operator=(const TodoList&) = delete;
+
     // Adds a new task with the given description
     void addTask(const std::string& description);
 
@@ -22,26 +155,117 @@ public:
     // Marks a task as completed by ID; returns true if it exists and was updated
     bool markTaskAsCompleted(int id);
 
+    // Bulk versions of the calls above. Observers still hear about every task, but the work that can be
+    // shared is done once per call: addTasks reserves once and hands out one block of consecutive IDs (all
+    // sharing one creation date), and the removes compact at the end only if the tombstone threshold is crossed.
+    // addTasks returns the first new ID; it throws std::invalid_argument, adding nothing, if any description
+    // is empty. completeTasks/removeTasks skip IDs that don't exist and return how many tasks they changed;
+    // removeTasks works (and tells the observer) in list order rather than in the order of ids.
+    int addTasks(std::span<const std::string> descriptions);
+    std::size_t completeTasks(std::span<const int> ids);
+    std::size_t removeTasks(std::span<const int> ids);
+
+    // Removes every task for which pred(const Task&) returns true; returns how many were removed.
+    // The predicate sees every live task, in list order, before anything is removed.
+    template <typename Predicate>
+    std::size_t removeIf(Predicate&& pred);
+
+    // Stores a task exactly as given (ID, status and dates included), replacing any task with the same ID.
+    // Used to replay persisted changes; new IDs are appended and bump nextTaskId past them.
+    void upsertTask(const Task& task);
+
     // Returns a copy of all tasks (both completed and pending)
     std::vector<Task> getAllTasks() const;
 
+    // Non-copying alternatives to the getters above: views into the list's own storage
+    // (valid until the next add/remove/set/clear call)
+    TaskView viewAllTasks() const;
+    TaskView viewCompletedTasks() const;  // Only touches completed tasks, in list order
+    TaskView viewPendingTasks() const;    // Only touches pending tasks, in list order
+
+    // Finds the tasks matching a query, in list order. Word terms and prefixes go through the search index;
+    // a query with only a substring (and/or status) scans the descriptions instead.
+    // The view is valid until the next add/remove/set/clear call or the next search or time query.
+    TaskView search(const TaskQuery& query) const;
+
+    // Time queries with inclusive bounds, oldest first; views are valid like search results
+    TaskView createdBetween(time_t from, time_t to) const;
+    TaskView completedBetween(time_t from, time_t to) const;
+    TaskView oldestPending(std::size_t count) const;  // The count pending tasks created first
+
+    // How many tasks were created / completed on each local calendar day from from's day through to's day
+    std::vector<DayCount> createdPerDay(time_t from, time_t to) const;
+    std::vector<DayCount> completedPerDay(time_t from, time_t to) const;
+
+    // Copies the live tasks, in list order, into a columnar TaskStore for scans and compact storage
+    TaskStore buildTaskStore() const;
+
     // Returns a pointer to a task by ID, or nullptr if it’s not found
+    // (the pointer stays valid until the next add/remove/set call; use markTaskAsCompleted
+    // rather than calling markAsCompleted through it, so the status counts stay in sync)
     Task* getTaskById(int id);
 
-    // Clears the entire task list
+    // Clears the entire task list; the memory goes back in one step by dropping the arena
     void clearAllTasks();
 
     // Returns the total number of tasks
     int getTaskCount() const;
 
+    // Bytes the list's arena currently holds from the heap (tasks, descriptions and the ID/status indexes),
+    // in O(1). Search and time indexes are built on demand and not counted.
+    std::size_t memoryUsage() const { return arenaUpstream.bytes; }
+
+    // Counts changes: every add/upsert/complete/remove/clear and every setTasks bumps it by one, so two equal
+    // readings mean the tasks haven't changed in between (used to tell whether a saved copy is stale)
+    std::uint64_t getGeneration() const { return generation; }
+
+    // Change tracking for incremental saves. markCheckpoint() returns a new token (unique across every list)
+    // and starts tracking from the current state; firstSlotChangedSince(token) is the lowest slot whose task
+    // changed or moved since then (getSlots().size() if none did), or 0 if token isn't this list's latest
+    // checkpoint, so a stale token always means "everything changed".
+    std::uint64_t markCheckpoint();
+    std::size_t firstSlotChangedSince(std::uint64_t token) const;
+
+    // Every slot in list order, tombstones (ID 0) included: what callers that track positions index by
+    std::span<const Task> getSlots() const { return storage->tasks; }
+
+    // Returns how many tasks are completed / still pending, in O(1)
+    int getCompletedCount() const;
+    int getPendingCount() const;
+
     // Returns only the tasks that are marked as completed
     std::vector<Task> getCompletedTasks() const;
 
     // Returns only the tasks that are still pending
     std::vector<Task> getPendingTasks() const;
 
-    // Replaces the current task list with a new one (useful when loading from file)
+    // Replaces the current task list with a new one (useful when loading from file).
+    // Tasks are rebuilt inside the list's arena, so the source's descriptions are always copied once (there
+    // is no rvalue overload: the source's strings live on another resource, so moving them would copy anyway).
     void setTasks(const std::vector<Task>& tasks);
+    void setTasks(std::span<const TaskRecord> records); // Straight from parsed lines, no Task temporaries
+
+    // Registers an observer for add/complete/remove/clear (nullptr to detach).
+    // setTasks is treated as a load, not a change, so observers aren't told about it.
+    void setObserver(TodoListObserver* observer);
 };
 
+template <typename Predicate>
+std::size_t TodoList::removeIf(Predicate&& pred) {
+    std::vector<std::size_t> matches;
+    for (std::size_t slot = 0; slot < storage->tasks.size(); slot++) {
+        const Task& task = storage->tasks[slot];
+        if (!isTombstone(task) && pred(task)) {
+            matches.push_back(slot);
+        }
+    }
+
+    prepareBulkRemoval(matches.size());
+    for (std::size_t slot : matches) {
+        retireSlot(slot);
+    }
+    compactIfNeeded();
+    return matches.size();
+}
+
 #endif // TODOLIST_H
\ No newline at end of file
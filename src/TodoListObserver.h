@@ -0,0 +1,25 @@
+#ifndef TODOLIST_OBSERVER_H
+#define TODOLIST_OBSERVER_H
+
+#include "Task.h"
+
+// TodoListObserver gets told about every change a TodoList makes, right after it happens.
+// Used by anything that has to follow the list without rescanning it (e.g. the Journal).
+class TodoListObserver {
+public:
+    virtual ~TodoListObserver() = default;
+
+    // A task was added, or stored with an explicit ID (task holds its final contents)
+    virtual void onTaskAdded(const Task& task) = 0;
+
+    // A task was marked as completed (task holds its final contents)
+    virtual void onTaskCompleted(const Task& task) = 0;
+
+    // The task with this ID was removed
+    virtual void onTaskRemoved(int id) = 0;
+
+    // Every task was removed and the ID counter reset
+    virtual void onTasksCleared() = 0;
+};
+
+#endif // TODOLIST_OBSERVER_H
\ No newline at end of file
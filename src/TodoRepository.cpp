@@ -0,0 +1,245 @@
+#include "TodoRepository.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+
+namespace {
+
+const char* const listExtension = ".txt";
+
+} // namespace
+
+TodoRepository::Entry::Entry(const std::string& name, const std::string& path) : name(name), file(path) {
+    list.setObserver(this);
+}
+
+TodoRepository::Entry::~Entry() {
+    list.setObserver(nullptr);
+}
+
+TodoRepository::TodoRepository(const std::string& root, std::size_t memoryBudget,
+                               std::chrono::milliseconds flushInterval)
+    : root(root), memoryBudget(memoryBudget), flushInterval(flushInterval), totalBytes(0), stopping(false) {
+    try {
+        std::filesystem::create_directories(root);
+    } catch (const std::filesystem::filesystem_error& e) {
+        std::cerr << "Filesystem error: " << e.what() << std::endl;
+        throw std::runtime_error("Failed to initialize repository: " + std::string(e.what()));
+    }
+
+    if (flushInterval.count() > 0) {
+        flusher = std::thread(&TodoRepository::flushLoop, this);
+    }
+}
+
+TodoRepository::~TodoRepository() {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        stopping = true;
+    }
+    wakeFlusher.notify_one();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    flushAll();
+}
+
+bool TodoRepository::isValidName(const std::string& name) {
+    if (name.empty() || name.size() > 128 || name[0] == '.') {
+        return false;
+    }
+    return std::all_of(name.begin(), name.end(), [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+               c == '_' || c == '-' || c == '.';
+    });
+}
+
+std::shared_ptr<TodoRepository::Entry> TodoRepository::acquire(const std::string& name,
+                                                               std::unique_lock<std::mutex>& lock) {
+    if (!isValidName(name)) {
+        throw std::invalid_argument("Invalid task list name: '" + name + "'");
+    }
+
+    while (true) {
+        std::shared_ptr<Entry> entry;
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            auto it = entries.find(name);
+            if (it == entries.end()) {
+                entry = std::make_shared<Entry>(name, root + "/" + name + listExtension);
+                lru.push_front(name);
+                entry->lruPosition = lru.begin();
+                entries.emplace(name, entry);
+            } else {
+                entry = it->second;
+                lru.splice(lru.begin(), lru, entry->lruPosition);
+            }
+        }
+
+        // The file is read under the list's lock only, so loading one list never stalls the others
+        lock = std::unique_lock<std::mutex>(entry->mutex);
+        if (entry->evicted) {
+            lock.unlock();
+            continue;  // Saved and dropped while we waited; the next lookup loads it again
+        }
+        if (!entry->loaded) {
+            if (entry->file.fileExists() && !entry->file.loadInto(entry->list)) {
+                // Leave nothing behind, so the next access tries again
+                entry->evicted = true;
+                lock.unlock();
+                {
+                    std::lock_guard<std::mutex> guard(mutex);
+                    detach(entry);
+                }
+                throw std::runtime_error("Failed to load task list '" + name + "'");
+            }
+            entry->loaded = true;
+        }
+        return entry;
+    }
+}
+
+void TodoRepository::release(const std::shared_ptr<Entry>& entry, std::unique_lock<std::mutex>& lock) {
+    std::size_t bytes = entry->list.memoryUsage();
+    lock.unlock();
+
+    bool overBudget;
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        auto it = entries.find(entry->name);
+        if (it != entries.end() && it->second == entry) {
+            totalBytes += bytes;
+            totalBytes -= entry->bytes;
+            entry->bytes = bytes;
+        }
+        overBudget = totalBytes > memoryBudget;
+    }
+
+    if (overBudget) {
+        evictIfNeeded();
+    }
+}
+
+void TodoRepository::detach(const std::shared_ptr<Entry>& entry) {
+    auto it = entries.find(entry->name);
+    if (it == entries.end() || it->second != entry) {
+        return;
+    }
+    totalBytes -= entry->bytes;
+    lru.erase(entry->lruPosition);
+    entries.erase(it);
+}
+
+void TodoRepository::evictIfNeeded() {
+    while (true) {
+        std::shared_ptr<Entry> victim;
+        std::unique_lock<std::mutex> victimLock;  // Declared after victim so it unlocks before the entry goes
+
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (totalBytes <= memoryBudget || lru.size() < 2) {
+                return;
+            }
+            // Least recently used first, never the most recent one; lists in use are skipped, not waited for
+            for (auto it = lru.rbegin(); std::next(it) != lru.rend(); ++it) {
+                const std::shared_ptr<Entry>& candidate = entries.at(*it);
+                std::unique_lock<std::mutex> candidateLock(candidate->mutex, std::try_to_lock);
+                if (candidateLock.owns_lock()) {
+                    victim = candidate;
+                    victimLock = std::move(candidateLock);
+                    break;
+                }
+            }
+        }
+        if (!victim) {
+            return;
+        }
+
+        // Saved outside the repository lock, so other lists stay usable meanwhile
+        if (victim->dirty && !save(*victim)) {
+            std::cerr << "Error: Could not save task list '" << victim->name << "'; keeping it loaded." << std::endl;
+            return;
+        }
+        victim->evicted = true;
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            detach(victim);
+        }
+    }
+}
+
+bool TodoRepository::save(Entry& entry) {
+    if (!entry.file.saveTasks(entry.list)) {
+        return false;
+    }
+    entry.dirty = false;
+    return true;
+}
+
+bool TodoRepository::flush(const std::vector<std::shared_ptr<Entry>>& targets) {
+    bool ok = true;
+    for (const std::shared_ptr<Entry>& entry : targets) {
+        std::lock_guard<std::mutex> guard(entry->mutex);
+        if (entry->evicted || !entry->dirty) {
+            continue;
+        }
+        if (!save(*entry)) {
+            std::cerr << "Error: Could not save task list '" << entry->name << "'." << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+std::vector<std::shared_ptr<TodoRepository::Entry>> TodoRepository::loadedEntries() const {
+    std::lock_guard<std::mutex> guard(mutex);
+    std::vector<std::shared_ptr<Entry>> loaded;
+    loaded.reserve(entries.size());
+    for (const auto& [name, entry] : entries) {
+        loaded.push_back(entry);
+    }
+    return loaded;
+}
+
+void TodoRepository::flushLoop() {
+    std::unique_lock<std::mutex> guard(mutex);
+    while (!wakeFlusher.wait_for(guard, flushInterval, [this] { return stopping; })) {
+        guard.unlock();
+        flush(loadedEntries());
+        guard.lock();
+    }
+}
+
+bool TodoRepository::flushAll() {
+    return flush(loadedEntries());
+}
+
+std::vector<std::string> TodoRepository::listNames() const {
+    std::set<std::string> names;
+    std::error_code error;
+    for (const auto& file : std::filesystem::directory_iterator(root, error)) {
+        std::filesystem::path path = file.path();
+        std::string name = path.stem().string();
+        if (path.extension() == listExtension && isValidName(name)) {
+            names.insert(name);
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(mutex);
+    for (const auto& [name, entry] : entries) {
+        names.insert(name);
+    }
+    return std::vector<std::string>(names.begin(), names.end());
+}
+
+std::size_t TodoRepository::loadedCount() const {
+    std::lock_guard<std::mutex> guard(mutex);
+    return entries.size();
+}
+
+std::size_t TodoRepository::memoryUsage() const {
+    std::lock_guard<std::mutex> guard(mutex);
+    return totalBytes;
+}
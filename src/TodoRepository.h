@@ -0,0 +1,135 @@
+#ifndef TODO_REPOSITORY_H
+#define TODO_REPOSITORY_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "TodoList.h"
+#include "TodoListObserver.h"
+#include "FileManager.h"
+
+// TodoRepository serves many named task lists from one data root, each stored as "<root>/<name>.txt".
+//  - Lists are loaded on first access, so startup costs nothing however many lists exist.
+//  - Loaded lists sit in an LRU; once their arenas hold more than the memory budget, the least recently
+//    used idle lists are saved (if dirty) and dropped. The most recently used list always stays.
+//  - Every mutation marks its list dirty; a background thread saves dirty lists every flush interval,
+//    and whatever is still dirty is saved when the repository is destroyed.
+// Lists are only reached through with(), which holds the list's own lock for the call, so different lists
+// are used concurrently while each one still sees a single thread at a time.
+class TodoRepository {
+private:
+    // One loaded (or loading) list. Marks itself dirty by observing its own list.
+    struct Entry : public TodoListObserver {
+        std::string name;
+        std::mutex mutex;       // Held by with() and by saves; guards everything down to evicted
+        TodoList list;
+        FileManager file;
+        bool loaded = false;    // False until the file has been read
+        bool dirty = false;     // True if the list changed since it was last saved
+        bool evicted = false;   // Set once the entry left the repository (whoever waited on it looks again)
+
+        // Guarded by the repository's mutex
+        std::size_t bytes = 0;                        // Arena size when the list was last released
+        std::list<std::string>::iterator lruPosition; // Where the entry sits in lru
+
+        Entry(const std::string& name, const std::string& path);
+        ~Entry() override;
+
+        void onTaskAdded(const Task&) override { dirty = true; }
+        void onTaskCompleted(const Task&) override { dirty = true; }
+        void onTaskRemoved(int) override { dirty = true; }
+        void onTasksCleared() override { dirty = true; }
+    };
+
+    std::string root;                          // Directory holding every list's file
+    std::size_t memoryBudget;                  // Loaded lists are evicted above this many arena bytes
+    std::chrono::milliseconds flushInterval;   // Time between background saves (zero = no flusher thread)
+
+    mutable std::mutex mutex;                  // Guards entries, lru, totalBytes and stopping
+    std::unordered_map<std::string, std::shared_ptr<Entry>> entries;
+    std::list<std::string> lru;                // Loaded list names, most recently used first
+    std::size_t totalBytes;                    // Sum of every entry's bytes
+    bool stopping;                             // Tells the flusher to exit
+    std::condition_variable wakeFlusher;
+    std::thread flusher;
+
+    // Finds or loads a list and returns it with its lock held (throws if the file can't be loaded)
+    std::shared_ptr<Entry> acquire(const std::string& name, std::unique_lock<std::mutex>& lock);
+
+    // Unlocks a list after use, records its new size and evicts other lists if that broke the budget
+    void release(const std::shared_ptr<Entry>& entry, std::unique_lock<std::mutex>& lock);
+
+    // Removes an entry from the map and the LRU (repository mutex held)
+    void detach(const std::shared_ptr<Entry>& entry);
+
+    // Drops least recently used idle lists until the budget holds again (or nothing else can go)
+    void evictIfNeeded();
+
+    // Saves a list and clears its dirty flag (list lock held)
+    static bool save(Entry& entry);
+
+    // Saves every dirty list among the given ones; false if any save failed
+    static bool flush(const std::vector<std::shared_ptr<Entry>>& targets);
+
+    // Body of the flusher thread
+    void flushLoop();
+
+    // Every loaded entry, for flushing without holding the repository mutex
+    std::vector<std::shared_ptr<Entry>> loadedEntries() const;
+
+public:
+    explicit TodoRepository(const std::string& root = "data", std::size_t memoryBudget = 256u << 20,
+                            std::chrono::milliseconds flushInterval = std::chrono::seconds(1));
+
+    // Stops the flusher and saves every dirty list
+    ~TodoRepository();
+
+    TodoRepository(const TodoRepository&) = delete;
+    TodoRepository& operator=(const TodoRepository&) = delete;
+
+    // Calls fn(TodoList&) on the named list (loading it first if needed) and returns what fn returns.
+    // The list is locked for the call: don't keep views or task pointers past it, and don't call back into
+    // with() for the same list from inside fn. Throws std::invalid_argument for a bad name and
+    // std::runtime_error if the list's file can't be loaded.
+    template <typename Fn>
+    decltype(auto) with(const std::string& name, Fn&& fn);
+
+    // Saves every dirty list now; false if any save failed
+    bool flushAll();
+
+    // Names of every list, on disk or only in memory so far, sorted
+    std::vector<std::string> listNames() const;
+
+    // How many lists are in memory, and the arena bytes they hold between them
+    std::size_t loadedCount() const;
+    std::size_t memoryUsage() const;
+
+    // Names are 1-128 letters, digits, '_', '-' or '.', not starting with '.', so they map to plain file names
+    static bool isValidName(const std::string& name);
+};
+
+template <typename Fn>
+decltype(auto) TodoRepository::with(const std::string& name, Fn&& fn) {
+    std::unique_lock<std::mutex> lock;
+    std::shared_ptr<Entry> entry = acquire(name, lock);
+
+    // Releases the list however fn exits
+    struct Release {
+        TodoRepository& repository;
+        const std::shared_ptr<Entry>& entry;
+        std::unique_lock<std::mutex>& lock;
+        ~Release() { repository.release(entry, lock); }
+    } release{*this, entry, lock};
+
+    return std::forward<Fn>(fn)(entry->list);
+}
+
+#endif // TODO_REPOSITORY_H
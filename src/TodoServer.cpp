@@ -0,0 +1,383 @@
+#include "TodoServer.h"
+#include <cerrno>
+#include <cstring>           // For std::memchr, std::memcpy and std::strerror
+#include <iostream>          // For errors on std::cerr
+#include <arpa/inet.h>       // For htons / htonl
+#include <fcntl.h>           // For open
+#include <netinet/in.h>      // For sockaddr_in
+#include <netinet/tcp.h>     // For TCP_NODELAY
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>          // For sockaddr_un
+#include <unistd.h>          // For read, write, close and unlink
+
+namespace {
+
+constexpr int maxEvents = 1024;
+constexpr std::size_t readChunk = 64 * 1024;
+
+void reportError(const std::string& what) {
+    std::cerr << "Error: " << what << ": " << std::strerror(errno) << std::endl;
+}
+
+} // namespace
+
+TodoServer::TodoServer(CommandInterpreter& commands)
+    : commands(commands), epollFd(epoll_create1(EPOLL_CLOEXEC)), wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      reserveFd(open("/dev/null", O_RDONLY | O_CLOEXEC)), connectionCount(0), stopping(false),
+      readBuffer(std::make_unique<char[]>(readChunk)) {
+    if (epollFd < 0 || wakeFd < 0) {
+        reportError("Could not set up the event loop");
+        return;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+}
+
+TodoServer::~TodoServer() {
+    for (std::unique_ptr<Connection>& connection : connections) {
+        if (connection) {
+            close(connection->fd);
+        }
+    }
+    for (const Listener& listener : listeners) {
+        close(listener.fd);
+    }
+    if (!unixPath.empty()) {
+        unlink(unixPath.c_str());
+    }
+    for (int fd : {epollFd, wakeFd, reserveFd}) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+bool TodoServer::addListener(int fd, bool tcp) {
+    if (listen(fd, SOMAXCONN) < 0) {
+        reportError("Could not listen");
+        close(fd);
+        return false;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        reportError("Could not watch the listening socket");
+        close(fd);
+        return false;
+    }
+    listeners.push_back({fd, tcp});
+    return true;
+}
+
+bool TodoServer::listenUnix(const std::string& path) {
+    sockaddr_un address{};
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Unix socket path is empty or too long: " << path << std::endl;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        reportError("Could not create a Unix socket");
+        return false;
+    }
+    unlink(path.c_str());  // A socket file left behind by a previous run would make bind fail
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        reportError("Could not bind " + path);
+        close(fd);
+        return false;
+    }
+    if (!addListener(fd, false)) {
+        unlink(path.c_str());
+        return false;
+    }
+    unixPath = path;
+    return true;
+}
+
+bool TodoServer::listenTcp(std::uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        reportError("Could not create a TCP socket");
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        reportError("Could not bind 127.0.0.1:" + std::to_string(port));
+        close(fd);
+        return false;
+    }
+    return addListener(fd, true);
+}
+
+void TodoServer::run() {
+    epoll_event events[maxEvents];
+    while (!stopping.load(std::memory_order_relaxed)) {
+        int ready = epoll_wait(epollFd, events, maxEvents, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            reportError("Event loop failed");
+            return;
+        }
+
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+            if (fd == wakeFd) {
+                continue;  // stop() already set stopping
+            }
+
+            bool isListener = false;
+            for (const Listener& listener : listeners) {
+                if (listener.fd == fd) {
+                    acceptClients(listener);
+                    isListener = true;
+                    break;
+                }
+            }
+            if (isListener || static_cast<std::size_t>(fd) >= connections.size() || !connections[fd]) {
+                continue;  // Also skips a connection an earlier event in this batch closed
+            }
+
+            Connection& connection = *connections[fd];
+            std::uint32_t happened = events[i].events;
+            if (happened & (EPOLLERR | EPOLLHUP) && !(happened & EPOLLIN)) {
+                closeConnection(connection);
+                continue;
+            }
+            if (happened & EPOLLOUT) {
+                onWritable(connection);
+                if (!connections[fd]) {
+                    continue;
+                }
+            }
+            if (happened & EPOLLIN) {
+                onReadable(connection);
+            }
+        }
+    }
+}
+
+void TodoServer::stop() {
+    stopping.store(true, std::memory_order_relaxed);
+    std::uint64_t one = 1;
+    ssize_t written = write(wakeFd, &one, sizeof(one));
+    (void)written;  // Already pending if it fails: the loop wakes up either way
+}
+
+void TodoServer::acceptClients(const Listener& listener) {
+    while (true) {
+        int fd = accept4(listener.fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if ((errno == EMFILE || errno == ENFILE) && reserveFd >= 0) {
+                // Out of descriptors: the listener would stay readable forever, so accept the client with the
+                // spare descriptor and hang up on it right away
+                close(reserveFd);
+                int shed = accept(listener.fd, nullptr, nullptr);
+                if (shed >= 0) {
+                    close(shed);
+                }
+                reserveFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+                std::cerr << "Warning: Out of file descriptors; refused a client." << std::endl;
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                reportError("Could not accept a client");
+            }
+            return;
+        }
+
+        if (listener.tcp) {
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        if (static_cast<std::size_t>(fd) >= connections.size()) {
+            connections.resize(static_cast<std::size_t>(fd) + 1);
+        }
+        connections[fd] = std::make_unique<Connection>(fd);
+        connectionCount++;
+        updateEvents(*connections[fd]);
+    }
+}
+
+void TodoServer::onReadable(Connection& connection) {
+    // Level-triggered: whatever isn't read now wakes us again, so a busy client can't starve the others
+    bool endOfInput = false;
+    for (int reads = 0; reads < 4; reads++) {
+        ssize_t bytes = recv(connection.fd, readBuffer.get(), readChunk, 0);
+        if (bytes == 0) {
+            endOfInput = true;
+            break;
+        }
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            closeConnection(connection);
+            return;
+        }
+        connection.input.append(readBuffer.get(), static_cast<std::size_t>(bytes));
+        if (static_cast<std::size_t>(bytes) < readChunk) {
+            break;
+        }
+    }
+
+    // A last command without a newline still counts once the client has finished sending
+    if (endOfInput) {
+        if (!connection.input.empty() && connection.input.back() != '\n') {
+            connection.input += '\n';
+        }
+        connection.closing = true;
+    }
+
+    if (!serve(connection)) {
+        closeConnection(connection);
+        return;
+    }
+    updateEvents(connection);
+}
+
+void TodoServer::onWritable(Connection& connection) {
+    // Sends what's pending, then picks up commands held back while the client owed too much output
+    if (!serve(connection)) {
+        closeConnection(connection);
+        return;
+    }
+    updateEvents(connection);
+}
+
+bool TodoServer::serve(Connection& connection) {
+    while (true) {
+        bool heldBack = runCommands(connection);
+        if (!flush(connection)) {
+            return false;
+        }
+        if (!heldBack || pendingOutput(connection) > 0) {
+            return true;
+        }
+    }
+}
+
+bool TodoServer::runCommands(Connection& connection) {
+    std::string& input = connection.input;
+    std::size_t consumed = 0;
+    bool quit = false;
+
+    bool heldBack = false;
+    while (consumed < input.size()) {
+        if (pendingOutput(connection) >= maxPendingOutput) {
+            heldBack = true;
+            break;
+        }
+        const char* start = input.data() + consumed;
+        const void* newline = std::memchr(start, '\n', input.size() - consumed);
+        if (!newline) {
+            if (input.size() - consumed > maxLineLength) {
+                connection.output += "ERR line too long\n";
+                quit = true;
+            }
+            break;
+        }
+        std::size_t length = static_cast<const char*>(newline) - start;
+        std::string_view command = CommandInterpreter::trim(std::string_view(start, length));
+        consumed += length + 1;
+
+        if (command.empty() || command.front() == '#') {
+            continue;
+        }
+        if (command == "quit") {
+            connection.output += "OK\n";
+            quit = true;
+            break;
+        }
+        if (commands.execute(command, connection.output, error)) {
+            connection.output += "OK\n";
+        } else {
+            connection.output += "ERR ";
+            connection.output += error;
+            connection.output += '\n';
+        }
+    }
+
+    if (quit) {
+        connection.closing = true;
+        input.clear();
+        return false;
+    }
+    input.erase(0, consumed);
+    return heldBack;
+}
+
+bool TodoServer::flush(Connection& connection) {
+    while (pendingOutput(connection) > 0) {
+        ssize_t bytes = send(connection.fd, connection.output.data() + connection.outputSent,
+                             pendingOutput(connection), MSG_NOSIGNAL);
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        connection.outputSent += static_cast<std::size_t>(bytes);
+    }
+    connection.output.clear();
+    connection.outputSent = 0;
+    return true;
+}
+
+void TodoServer::updateEvents(Connection& connection) {
+    bool owesOutput = pendingOutput(connection) > 0;
+    if (connection.closing && !owesOutput) {
+        closeConnection(connection);
+        return;
+    }
+
+    std::uint32_t wanted = 0;
+    if (!connection.closing && pendingOutput(connection) < maxPendingOutput) {
+        wanted |= EPOLLIN;
+    }
+    if (owesOutput) {
+        wanted |= EPOLLOUT;
+    }
+    if (wanted == connection.events) {
+        return;
+    }
+
+    epoll_event event{};
+    event.events = wanted;
+    event.data.fd = connection.fd;
+    int operation = connection.events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+    if (epoll_ctl(epollFd, operation, connection.fd, &event) < 0) {
+        reportError("Could not watch a client");
+        closeConnection(connection);
+        return;
+    }
+    connection.events = wanted;
+}
+
+void TodoServer::closeConnection(Connection& connection) {
+    int fd = connection.fd;
+    close(fd);  // Also drops it from the epoll set
+    connections[fd].reset();
+    connectionCount--;
+}
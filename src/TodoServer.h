@@ -0,0 +1,109 @@
+#ifndef TODO_SERVER_H
+#define TODO_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "CommandInterpreter.h"
+
+// TodoServer serves CommandInterpreter commands to local clients over a Unix domain socket and/or loopback TCP.
+// The protocol is line-based: a client sends one command per line, and for each one gets back the command's
+// output lines followed by one status line, "OK" or "ERR <message>". Blank lines and '#' comments get no reply,
+// and "quit" answers OK and closes the connection once the replies are sent.
+// Clients may pipeline: every complete line in a read is run in order and all the replies go out in one send.
+// Everything runs on one thread around a level-triggered epoll loop, so the list itself needs no locking.
+// A client that stops reading its replies is paused (no more reads or commands) once it owes
+// maxPendingOutput bytes, and resumed as they drain.
+class TodoServer {
+private:
+    struct Connection {
+        int fd;
+        std::string input;           // Bytes received but not yet run (ends with an incomplete line, if any)
+        std::string output;          // Replies not yet sent
+        std::size_t outputSent = 0;  // Prefix of output already sent
+        bool closing = false;        // Close once output drains (quit, end of input or a protocol error)
+        std::uint32_t events = 0;    // Events currently registered with epoll
+
+        explicit Connection(int fd) : fd(fd) {}
+    };
+
+    struct Listener {
+        int fd;
+        bool tcp;                    // Accepted sockets get TCP_NODELAY
+    };
+
+    CommandInterpreter& commands;
+    int epollFd;
+    int wakeFd;                      // eventfd that stop() writes to
+    int reserveFd;                   // Spare descriptor, given up to shed a client when out of descriptors
+    std::vector<Listener> listeners;
+    std::string unixPath;            // Socket file to remove on shutdown (empty if none)
+    std::vector<std::unique_ptr<Connection>> connections;  // Indexed by descriptor
+    std::size_t connectionCount;
+    std::atomic<bool> stopping;
+    std::string error;               // Reused for command error messages
+    std::unique_ptr<char[]> readBuffer;  // Every recv lands here before being appended to a client's input
+
+    // Registers a listening socket with the event loop
+    bool addListener(int fd, bool tcp);
+
+    // Accepts every waiting client on a listener
+    void acceptClients(const Listener& listener);
+
+    // Reads what the client sent, runs it and sends the replies
+    void onReadable(Connection& connection);
+
+    // Sends pending replies, resuming a paused client as they drain
+    void onWritable(Connection& connection);
+
+    // Runs the complete lines in input until they run out or the client owes too much output;
+    // true if it stopped because of the output
+    bool runCommands(Connection& connection);
+
+    // Alternates runCommands and flush until the input runs dry or the socket stops taking data;
+    // false if the connection broke
+    bool serve(Connection& connection);
+
+    // Sends as much of output as the socket takes; false if the connection broke
+    bool flush(Connection& connection);
+
+    // Registers the events the connection needs now (or closes it if it's done)
+    void updateEvents(Connection& connection);
+
+    void closeConnection(Connection& connection);
+
+    std::size_t pendingOutput(const Connection& connection) const {
+        return connection.output.size() - connection.outputSent;
+    }
+
+public:
+    static constexpr std::size_t maxLineLength = 1 << 20;     // Longer lines are refused and the client dropped
+    static constexpr std::size_t maxPendingOutput = 4 << 20;  // Unsent reply bytes before a client is paused
+
+    explicit TodoServer(CommandInterpreter& commands);
+
+    // Closes every connection and listener and removes the Unix socket file
+    ~TodoServer();
+
+    TodoServer(const TodoServer&) = delete;
+    TodoServer& operator=(const TodoServer&) = delete;
+
+    // Start listening; false (with a message on std::cerr) if the socket can't be set up.
+    // A stale socket file at path is replaced. TCP only binds 127.0.0.1.
+    bool listenUnix(const std::string& path);
+    bool listenTcp(std::uint16_t port);
+
+    // Serves clients until stop() is called
+    void run();
+
+    // Makes run() return; safe to call from another thread or a signal handler
+    void stop();
+
+    // Number of clients connected right now
+    std::size_t clientCount() const { return connectionCount; }
+};
+
+#endif // TODO_SERVER_H
@@ -0,0 +1,62 @@
+#ifndef VARINT_H
+#define VARINT_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Varint is the integer coding of the binary snapshot columns (see BinarySnapshot.h): unsigned LEB128, 7 bits
+// per byte with the high bit set on all but the last byte, so values below 128 take one byte and no value
+// takes more than maxSize. Signed differences go through zigzag first, so small negative ones stay short.
+class Varint {
+public:
+    static constexpr std::size_t maxSize = 10;  // Bytes of the largest 64-bit value
+
+    // Zigzag mapping: 0, -1, 1, -2, 2, ... become 0, 1, 2, 3, 4, ...
+    static std::uint64_t zigzag(std::int64_t value) {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    static std::uint64_t unzigzag(std::uint64_t value) {
+        return (value >> 1) ^ (0 - (value & 1));
+    }
+
+    // Difference between two values as a zigzag code (wraps instead of overflowing)
+    static std::uint64_t deltaCode(std::int64_t value, std::int64_t previous) {
+        std::uint64_t difference = static_cast<std::uint64_t>(value) - static_cast<std::uint64_t>(previous);
+        return zigzag(static_cast<std::int64_t>(difference));
+    }
+
+    // Appends the value's varint
+    static void put(std::string& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    // Bytes put takes for the value
+    static std::size_t size(std::uint64_t value) {
+        return (static_cast<std::size_t>(std::bit_width(value | 1)) + 6) / 7;
+    }
+
+    // Reads one varint from [p, end) and advances p past it; false if it runs past the end or over 64 bits
+    static bool read(const char*& p, const char* end, std::uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && p < end; shift += 7) {
+            std::uint8_t byte = static_cast<std::uint8_t>(*p++);
+            if (shift == 63 && byte > 1) {
+                return false;  // The tenth byte only has room for bit 63
+            }
+            value |= std::uint64_t(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+#endif // VARINT_H
@@ -1,11 +1,24 @@
 #include <iostream>                     // Standard input/output stream
 #include <string>                       // String manipulation
 #include <limits>                       // For std::numeric_limits
-#include <iomanip>                      // For formatted output like std::setw
+#include <iomanip>                      // For std::setprecision in the batch summary
 #include <stdexcept>                   // For standard exceptions
 #include "Task.h"                       // Task class declaration
+#include "TaskView.h"                   // Non-owning views over a TodoList
+#include "TaskFormatter.h"              // Buffered task table rendering
 #include "TodoList.h"                   // TodoList class declaration
 #include "FileManager.h"                // FileManager class declaration
+#include "CompressedText.h"             // Compressed task files (--compress)
+#include "Journal.h"                    // Write-ahead journal (--journal mode)
+#include "AutoSaver.h"                  // Background saves (--autosave mode)
+#include "BatchRunner.h"                // Non-interactive command runner (--batch mode)
+#include "TodoServer.h"                 // Socket server (--serve mode)
+#include <memory>                       // For std::unique_ptr
+#include <fstream>                      // For reading a batch file
+#include <csignal>                      // For stopping the server on SIGINT / SIGTERM
+#include <cstdlib>                      // For std::atoi on the server port and autosave interval
+#include <mutex>                        // For the autosave list lock
+#include <sys/resource.h>               // For raising the descriptor limit in server mode
 
 // Clears the console screen based on the OS
 void clearScreen() {
@@ -45,34 +58,19 @@ void displayMenu() {
 }
 
 // Displays a formatted list of tasks
-void displayTasks(const std::vector<Task>& tasks) {
+void displayTasks(const TaskView& tasks) {
     if (tasks.empty()) {
         std::cout << "\nNo tasks to display.\n";
         return;
     }
 
-    // Table header
-    std::cout << "\n----- Your Tasks -----\n";
-    std::cout << std::left << std::setw(5) << "ID" << " | "
-              << std::setw(8) << "STATUS" << " | "
-              << std::setw(30) << "DESCRIPTION" << " | "
-              << "CREATED ON\n";
-    std::cout << std::string(70, '-') << "\n";
-
-    // Iterates through tasks and prints details
-    for (const auto& task : tasks) {
-        std::string status = task.isCompleted() ? "DONE" : "PENDING";
-        std::cout << std::left << std::setw(5) << task.getId() << " | "
-                  << std::setw(8) << status << " | "
-                  << std::setw(30) << (task.getDescription().length() > 27 ?
-                      task.getDescription().substr(0, 27) + "..." :
-                      task.getDescription()) << " | "
-                  << task.getFormattedCreationDate() << "\n";
-    }
+    // Header, rows and footer are built in one buffer and written out in large blocks
+    TaskTableWriter(std::cout).write(tasks);
+}
 
-    // Table footer
-    std::cout << std::string(70, '-') << "\n";
-    std::cout << "Total: " << tasks.size() << " task(s)\n";
+// Holds the autosaver's list lock for one change (an empty lock without --autosave)
+std::unique_lock<std::mutex> lockForChange(AutoSaver* autoSaver) {
+    return autoSaver ? autoSaver->lockList() : std::unique_lock<std::mutex>();
 }
 
 // Gets and validates user's menu choice
@@ -92,23 +90,223 @@ int getMenuChoice() {
     }
 }
 
+// Prints the command-line options
+void printUsage(std::ostream& out, const char* program) {
+    out << "Usage: " << program
+        << " [--journal | --journal-sync | --autosave [seconds]] [--binary | --compress] [--incremental-saves]"
+        << " [--batch [file|-] | --serve unix:<path>|tcp:<port>]\n"
+        << "  --journal            log every change to <task file>.journal as it happens; each change survives the\n"
+        << "                       program crashing, but is not fsynced, so a power loss can drop the last ones\n"
+        << "  --journal-sync       like --journal, but fsyncs every change before going on (durable, but slower)\n"
+        << "  --autosave [seconds] save changes in the background, at most this long after they're made (2)\n"
+        << "  --binary, --compress save as a binary snapshot / zstd-compressed text (journal snapshots too)\n"
+        << "  --incremental-saves  rewrite only the changed end of the text file (a crash mid-save can tear it)\n"
+        << "  --batch [file|-]     run commands from a file or stdin instead of the menu\n"
+        << "  --serve <address>    serve commands on a Unix socket or loopback TCP port\n";
+}
+
+// Runs a command stream with no prompts or screen clears; returns the process exit code
+int runBatch(const std::string& batchPath, TodoList& todoList, FileManager& fileManager, Journal* journal) {
+    std::ifstream batchFile;
+    if (batchPath != "-") {
+        batchFile.open(batchPath);
+        if (!batchFile) {
+            std::cerr << "Could not open batch file: " << batchPath << "\n";
+            return 1;
+        }
+    }
+    std::istream& in = batchPath == "-" ? std::cin : batchFile;
+
+    // Fully buffered output: no stdio syncing, and reading a command no longer flushes std::cout
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    std::size_t replayed = 0;
+    if (journal) {
+        if (!journal->recover(todoList, replayed) || !journal->attach(todoList)) {
+            std::cerr << "Could not read the snapshot; not starting so the journal can't overwrite it.\n";
+            return 1;
+        }
+    } else if (fileManager.fileExists()) {
+        fileManager.loadInto(todoList);
+    }
+
+    BatchRunner runner(todoList, fileManager, journal, std::cout);
+    BatchStats stats = runner.run(in);
+    std::cout.flush();
+
+    // Summary goes to stderr so the command output stays machine-readable
+    double perSecond = stats.seconds > 0.0 ? static_cast<double>(stats.commands) / stats.seconds : 0.0;
+    std::cerr << stats.commands << " command(s), " << stats.errors << " error(s) in "
+              << std::fixed << std::setprecision(3) << stats.seconds << " s ("
+              << std::setprecision(0) << perSecond << " commands/s)\n";
+    return stats.errors == 0 ? 0 : 2;
+}
+
+// Server that SIGINT / SIGTERM should stop (set while runServer is serving)
+TodoServer* activeServer = nullptr;
+
+void stopServer(int) {
+    if (activeServer) {
+        activeServer->stop();
+    }
+}
+
+// Serves the list on "unix:<path>" or "tcp:<port>" until SIGINT / SIGTERM; returns the process exit code
+int runServer(const std::string& address, TodoList& todoList, FileManager& fileManager, Journal* journal) {
+    std::size_t replayed = 0;
+    if (journal) {
+        if (!journal->recover(todoList, replayed) || !journal->attach(todoList)) {
+            std::cerr << "Could not read the snapshot; not starting so the journal can't overwrite it.\n";
+            return 1;
+        }
+    } else if (fileManager.fileExists()) {
+        fileManager.loadInto(todoList);
+    }
+
+    // Every client holds a descriptor, so take all the process is allowed
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    CommandInterpreter commands(todoList, fileManager, journal);
+    TodoServer server(commands);
+    bool listening = false;
+    if (address.rfind("unix:", 0) == 0) {
+        listening = server.listenUnix(address.substr(5));
+    } else if (address.rfind("tcp:", 0) == 0) {
+        int port = std::atoi(address.c_str() + 4);
+        if (port > 0 && port <= 65535) {
+            listening = server.listenTcp(static_cast<std::uint16_t>(port));
+        } else {
+            std::cerr << "Invalid TCP port: " << address.substr(4) << "\n";
+        }
+    } else {
+        std::cerr << "Server address must be unix:<path> or tcp:<port>, not: " << address << "\n";
+    }
+    if (!listening) {
+        return 1;
+    }
+
+    activeServer = &server;
+    std::signal(SIGINT, stopServer);
+    std::signal(SIGTERM, stopServer);
+    std::cerr << "Serving " << todoList.getTaskCount() << " task(s) on " << address << "\n";
+    server.run();
+    activeServer = nullptr;
+
+    // Like leaving the menu: without a journal, only what clients saved is kept
+    if (journal && !(journal->compact() && journal->waitForCompaction())) {
+        std::cerr << "Snapshot failed; changes remain in the journal.\n";
+    }
+    std::cerr << "Server stopped.\n";
+    return 0;
+}
+
 // Main application logic
-int main() {
+int main(int argc, char* argv[]) {
     TodoList todoList;                  // Holds all tasks in memory
     FileManager fileManager;            // Manages file I/O
+    std::unique_ptr<Journal> journal;   // Logs every change as it happens (only with --journal)
+    bool journaling = false;            // --journal was given
+    FsyncPolicy journalSync = FsyncPolicy::Never; // When journal records are fsynced (--journal-sync)
+    std::unique_ptr<AutoSaver> autoSaver; // Saves changes in the background (only with --autosave)
+    int autosaveSeconds = -1;           // Longest a change waits to be saved (-1 = no autosave)
     bool running = true;                // Controls program loop
+    bool batch = false;                 // Run a command stream instead of the menu (--batch)
+    std::string batchPath = "-";        // Batch file to read ("-" = stdin)
+    std::string serveAddress;           // Where to serve clients instead of running the menu (--serve)
+
+    // Command-line options
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--journal") {
+            journaling = true;
+        } else if (arg == "--journal-sync") {
+            journaling = true;
+            journalSync = FsyncPolicy::Always;
+        } else if (arg == "--binary") {
+            fileManager.setSaveFormat(FileFormat::Binary); // Loading detects the format on its own
+        } else if (arg == "--compress") {
+            if (!CompressedText::available()) {
+                std::cerr << "--compress needs a build with zstd support\n";
+                return 1;
+            }
+            fileManager.setSaveFormat(FileFormat::Compressed);
+        } else if (arg == "--incremental-saves") {
+            fileManager.setIncrementalSaves(true); // Faster saves, but a crash mid-save can tear the file's tail
+        } else if (arg == "--batch") {
+            batch = true;
+            if (i + 1 < argc && (argv[i + 1][0] != '-' || std::string(argv[i + 1]) == "-")) {
+                batchPath = argv[++i];
+            }
+        } else if (arg == "--serve" && i + 1 < argc) {
+            serveAddress = argv[++i];
+        } else if (arg == "--autosave") {
+            autosaveSeconds = 2;
+            if (i + 1 < argc && argv[i + 1][0] >= '0' && argv[i + 1][0] <= '9') {
+                autosaveSeconds = std::atoi(argv[++i]);
+            }
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage(std::cout, argv[0]);
+            return 0;
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            printUsage(std::cerr, argv[0]);
+            return 1;
+        }
+    }
+
+    // Created once every option is in, so its snapshots use the chosen format
+    if (journaling) {
+        journal = std::make_unique<Journal>(fileManager.getFilePath(), journalSync, fileManager.getSaveFormat());
+    }
+
+    // The journal already puts every change on disk, and batch/server mode save on command
+    if (autosaveSeconds >= 0 && (journal || batch || !serveAddress.empty())) {
+        std::cerr << "--autosave only applies to the menu, without --journal\n";
+        return 1;
+    }
 
     try {
+        if (batch) {
+            return runBatch(batchPath, todoList, fileManager, journal.get());
+        }
+        if (!serveAddress.empty()) {
+            return runServer(serveAddress, todoList, fileManager, journal.get());
+        }
+
+        // In journal mode the state is the last snapshot plus every change logged since
+        if (journal) {
+            displayHeader();
+            std::cout << "Recovering tasks from snapshot and journal...\n";
+            std::size_t replayed = 0;
+            if (!journal->recover(todoList, replayed) || !journal->attach(todoList)) {
+                std::cerr << "Could not read the snapshot; not starting so the journal can't overwrite it.\n";
+                return 1;
+            }
+            std::cout << "Loaded " << todoList.getTaskCount() << " task(s) (" << replayed
+                      << " journal record(s) replayed).\n";
+            pauseScreen();
+        }
         // Load saved tasks on startup if file exists
-        if (fileManager.fileExists()) {
+        else if (fileManager.fileExists()) {
             displayHeader();
             std::cout << "Loading saved tasks...\n";
-            auto loadedTasks = fileManager.loadTasks();
-            todoList.setTasks(loadedTasks);
-            std::cout << "Loaded " << loadedTasks.size() << " task(s).\n";
+            fileManager.loadInto(todoList);
+            std::cout << "Loaded " << todoList.getTaskCount() << " task(s).\n";
             pauseScreen();
         }
 
+        // From here on the list is only changed under lockForChange, so the flusher can copy it at any time
+        if (autosaveSeconds >= 0) {
+            autoSaver = std::make_unique<AutoSaver>(todoList, fileManager.getFilePath(),
+                                                    std::chrono::seconds(autosaveSeconds));
+            autoSaver->setSaveFormat(fileManager.getSaveFormat());
+        }
+
         // Main program loop
         while (running) {
             displayHeader();
@@ -125,6 +323,7 @@ int main() {
                     std::getline(std::cin, description);
 
                     if (!description.empty()) {
+                        std::unique_lock<std::mutex> guard = lockForChange(autoSaver.get());
                         todoList.addTask(description);
                         std::cout << "\nTask added successfully!\n";
                     } else {
@@ -138,7 +337,7 @@ int main() {
                 case 2: { // View tasks
                     displayHeader();
                     std::cout << "=== VIEW ALL TASKS ===\n";
-                    displayTasks(todoList.getAllTasks());
+                    displayTasks(todoList.viewAllTasks());
                     pauseScreen();
                     break;
                 }
@@ -146,7 +345,7 @@ int main() {
                 case 3: { // Mark task as completed
                     displayHeader();
                     std::cout << "=== MARK TASK AS COMPLETED ===\n";
-                    displayTasks(todoList.getAllTasks());
+                    displayTasks(todoList.viewAllTasks());
 
                     if (todoList.getTaskCount() == 0) {
                         pauseScreen();
@@ -157,6 +356,7 @@ int main() {
                     int taskId;
                     if (std::cin >> taskId) {
                         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                        std::unique_lock<std::mutex> guard = lockForChange(autoSaver.get());
                         if (todoList.markTaskAsCompleted(taskId)) {
                             std::cout << "\nTask marked as completed!\n";
                         } else {
@@ -175,7 +375,7 @@ int main() {
                 case 4: { // Remove a task
                     displayHeader();
                     std::cout << "=== REMOVE TASK ===\n";
-                    displayTasks(todoList.getAllTasks());
+                    displayTasks(todoList.viewAllTasks());
 
                     if (todoList.getTaskCount() == 0) {
                         pauseScreen();
@@ -192,6 +392,7 @@ int main() {
                         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 
                         if (confirm == 'y' || confirm == 'Y') {
+                            std::unique_lock<std::mutex> guard = lockForChange(autoSaver.get());
                             if (todoList.removeTask(taskId)) {
                                 std::cout << "\nTask removed successfully!\n";
                             } else {
@@ -214,10 +415,21 @@ int main() {
                     displayHeader();
                     std::cout << "=== SAVE TASKS TO FILE ===\n";
 
-                    if (todoList.getTaskCount() == 0) {
+                    if (journal) {
+                        // Every change is already on disk; saving just folds the journal into a snapshot
+                        if (journal->compact()) {
+                            std::cout << "All changes are journaled; a fresh snapshot is being written in the background.\n";
+                        } else {
+                            std::cout << "Failed to start writing a snapshot (changes are still journaled).\n";
+                        }
+                    } else if (autoSaver) {
+                        // Changes are saved in the background anyway; this just doesn't wait for the interval
+                        autoSaver->save();
+                        std::cout << "Saving in the background (changes are also saved automatically).\n";
+                    } else if (todoList.getTaskCount() == 0) {
                         std::cout << "No tasks to save.\n";
                     } else {
-                        if (fileManager.saveTasks(todoList.getAllTasks())) {
+                        if (fileManager.saveTasks(todoList)) {
                             std::cout << "Tasks saved successfully.\n";
                         } else {
                             std::cout << "Failed to save tasks.\n";
@@ -232,7 +444,17 @@ int main() {
                     displayHeader();
                     std::cout << "=== LOAD TASKS FROM FILE ===\n";
 
-                    if (!fileManager.fileExists()) {
+                    if (journal) {
+                        // Throws away in-memory state that isn't logged (there is none) and rebuilds it
+                        std::size_t replayed = 0;
+                        if (journal->recover(todoList, replayed)) {
+                            std::cout << "Loaded " << todoList.getTaskCount() << " task(s) (" << replayed
+                                      << " journal record(s) replayed).\n";
+                        } else {
+                            std::cout << "Could not read the snapshot; journaling is stopped and neither file will "
+                                         "be changed.\n";
+                        }
+                    } else if (!fileManager.fileExists()) {
                         std::cout << "No saved file found.\n";
                     } else {
                         if (todoList.getTaskCount() > 0) {
@@ -247,9 +469,9 @@ int main() {
                             }
                         }
 
-                        auto loadedTasks = fileManager.loadTasks();
-                        todoList.setTasks(loadedTasks);
-                        std::cout << "Loaded " << loadedTasks.size() << " task(s).\n";
+                        std::unique_lock<std::mutex> guard = lockForChange(autoSaver.get());
+                        fileManager.loadInto(todoList);
+                        std::cout << "Loaded " << todoList.getTaskCount() << " task(s).\n";
                     }
 
                     pauseScreen();
@@ -260,12 +482,28 @@ int main() {
                     displayHeader();
                     std::cout << "=== EXIT ===\n";
 
-                    if (todoList.getTaskCount() > 0) {
+                    if (journal) {
+                        // Nothing can be lost, but leave a compact snapshot behind for the next start
+                        std::cout << "Writing snapshot...\n";
+                        if (journal->compact() && journal->waitForCompaction()) {
+                            std::cout << "Tasks saved successfully.\n";
+                        } else {
+                            std::cout << "Snapshot failed; changes remain in the journal.\n";
+                        }
+                    } else if (autoSaver) {
+                        // Only what changed since the last background save is left to write
+                        std::cout << "Saving remaining changes...\n";
+                        if (autoSaver->stop()) {
+                            std::cout << "Tasks saved successfully.\n";
+                        } else {
+                            std::cout << "Failed to save tasks.\n";
+                        }
+                    } else if (todoList.getTaskCount() > 0) {
                         std::cout << "Do you want to save your tasks before exiting? (y/n): ";
                         char save;
                         std::cin >> save;
                         if (save == 'y' || save == 'Y') {
-                            if (fileManager.saveTasks(todoList.getAllTasks())) {
+                            if (fileManager.saveTasks(todoList)) {
                                 std::cout << "Tasks saved successfully.\n";
                             } else {
                                 std::cout << "Failed to save tasks.\n";
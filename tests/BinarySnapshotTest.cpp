@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "BinarySnapshot.h"
+#include "FileManager.h"
+#include "Varint.h"
+
+// Version 2 snapshots: the zigzag / LEB128 coding on its own, then whole snapshots round-tripped with column
+// patterns that move the loader in and out of its eight-at-a-time path, and cut short at every length.
+
+namespace {
+
+constexpr std::int64_t int64Min = std::numeric_limits<std::int64_t>::min();
+constexpr std::int64_t int64Max = std::numeric_limits<std::int64_t>::max();
+
+std::vector<std::uint64_t> interestingValues() {
+    std::vector<std::uint64_t> values;
+    for (std::uint64_t value = 0; value < 300; value++) values.push_back(value);
+    for (int bit = 7; bit < 64; bit++) {
+        std::uint64_t power = std::uint64_t(1) << bit;
+        values.insert(values.end(), {power - 1, power, power + 1});
+    }
+    values.push_back(std::numeric_limits<std::uint64_t>::max());
+    return values;
+}
+
+TEST(VarintTest, RoundTripsEverySize) {
+    for (std::uint64_t value : interestingValues()) {
+        std::string bytes;
+        Varint::put(bytes, value);
+        ASSERT_EQ(bytes.size(), Varint::size(value)) << value;
+        ASSERT_LE(bytes.size(), Varint::maxSize);
+
+        const char* p = bytes.data();
+        std::uint64_t decoded = 0;
+        ASSERT_TRUE(Varint::read(p, bytes.data() + bytes.size(), decoded)) << value;
+        EXPECT_EQ(decoded, value);
+        EXPECT_EQ(p, bytes.data() + bytes.size());
+    }
+
+    std::string largest;
+    Varint::put(largest, std::numeric_limits<std::uint64_t>::max());
+    EXPECT_EQ(largest.size(), 10u);
+}
+
+TEST(VarintTest, RejectsTruncatedAndOverlongInput) {
+    for (std::uint64_t value : interestingValues()) {
+        std::string bytes;
+        Varint::put(bytes, value);
+        for (std::size_t length = 0; length < bytes.size(); length++) {
+            const char* p = bytes.data();
+            std::uint64_t decoded;
+            EXPECT_FALSE(Varint::read(p, bytes.data() + length, decoded)) << value << " cut to " << length;
+        }
+    }
+
+    // Eleven bytes, or a tenth byte with more than bit 63 in it, don't fit in 64 bits
+    std::string overlong(10, '\x80');
+    overlong += '\x01';
+    std::string overflowing(9, '\xff');
+    overflowing += '\x02';
+    for (const std::string& bytes : {overlong, overflowing}) {
+        const char* p = bytes.data();
+        std::uint64_t decoded;
+        EXPECT_FALSE(Varint::read(p, bytes.data() + bytes.size(), decoded));
+    }
+}
+
+TEST(VarintTest, ZigzagDeltasWrapAround) {
+    std::vector<std::int64_t> values = {0, 1, -1, 63, -64, 64, -65, int64Max, int64Min, int64Max - 1, int64Min + 1};
+    for (std::int64_t value : values) {
+        EXPECT_EQ(static_cast<std::int64_t>(Varint::unzigzag(Varint::zigzag(value))), value);
+        for (std::int64_t previous : values) {
+            std::uint64_t restored = static_cast<std::uint64_t>(previous) +
+                                     Varint::unzigzag(Varint::deltaCode(value, previous));
+            EXPECT_EQ(static_cast<std::int64_t>(restored), value) << value << " after " << previous;
+        }
+    }
+    EXPECT_EQ(Varint::zigzag(-1), 1u);
+    EXPECT_EQ(Varint::zigzag(63), 126u);   // Still one byte
+    EXPECT_EQ(Varint::zigzag(-64), 127u);
+}
+
+class BinarySnapshotTest : public ::testing::Test {
+protected:
+    std::string directory = ::testing::TempDir() + "todo_binary_snapshot_test";
+    std::string path = directory + "/tasks.bin";
+
+    void SetUp() override {
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+    }
+    void TearDown() override { std::filesystem::remove_all(directory); }
+
+    std::string write(const std::vector<Task>& tasks) {
+        FileManager file(path);
+        file.setFsyncPolicy(FsyncPolicy::Never);
+        file.setSaveFormat(FileFormat::Binary);
+        EXPECT_TRUE(file.saveTasks(tasks));
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream contents;
+        contents << in.rdbuf();
+        return contents.str();
+    }
+
+    void expectRoundTrip(const std::vector<Task>& tasks) {
+        std::string contents = write(tasks);
+        std::vector<Task> loaded;
+        std::string error;
+        ASSERT_TRUE(BinarySnapshot::read(contents, loaded, error)) << error;
+        ASSERT_EQ(loaded.size(), tasks.size());
+        for (std::size_t i = 0; i < tasks.size(); i++) {
+            EXPECT_EQ(loaded[i].getId(), tasks[i].getId()) << "task " << i;
+            EXPECT_EQ(loaded[i].getDescription(), tasks[i].getDescription()) << "task " << i;
+            EXPECT_EQ(loaded[i].isCompleted(), tasks[i].isCompleted()) << "task " << i;
+            EXPECT_EQ(loaded[i].getCreationDate(), tasks[i].getCreationDate()) << "task " << i;
+            EXPECT_EQ(loaded[i].getCompletionDate(), tasks[i].isCompleted() ? tasks[i].getCompletionDate() : 0)
+                << "task " << i;
+        }
+
+        // The TaskStore reader decodes through the other sink
+        TaskStore store;
+        ASSERT_TRUE(BinarySnapshot::read(contents, store, error)) << error;
+        EXPECT_EQ(store.size(), tasks.size());
+    }
+};
+
+} // namespace
+
+// Runs of one-byte IDs, dates and lengths (the eight-at-a-time path) broken at every offset by one task that
+// needs long varints: a big ID jump, a date 2^62 seconds away, a 200-byte description, extreme completions
+TEST_F(BinarySnapshotTest, RoundTripsAroundTheEightAtATimePath) {
+    for (std::size_t count = 0; count <= 40; count++) {
+        for (std::size_t breakAt = 0; breakAt <= count; breakAt += 3) {
+            std::vector<Task> tasks;
+            int id = 0;
+            time_t date = 1'700'000'000;
+            for (std::size_t i = 0; i < count; i++) {
+                bool odd = i == breakAt;
+                id += odd ? 1'000'000 : 1;
+                date += odd ? (time_t(1) << 62) : 1;
+                std::string description = odd ? std::string(200, 'd') : "task " + std::to_string(i);
+                bool completed = i % 5 == 0;
+                time_t completion = odd ? int64Min : date + 60;
+                tasks.emplace_back(id, description, completed, date, completed ? completion : 0);
+            }
+            expectRoundTrip(tasks);
+        }
+    }
+}
+
+TEST_F(BinarySnapshotTest, RoundTripsExtremeValues) {
+    std::vector<Task> tasks = {
+        Task(std::numeric_limits<int>::max(), "largest id", true, int64Min, int64Max),
+        Task(1, "back to one", true, int64Max, int64Min),
+        Task(2, "negative date", false, -1, 0),
+        Task(3, "epoch", true, 0, 0),
+        Task(4, std::string(100'000, 'x'), false, 5, 0),
+    };
+    expectRoundTrip(tasks);
+
+    std::mt19937_64 random(5);
+    std::vector<Task> randomTasks;
+    for (int i = 0; i < 2000; i++) {
+        time_t created = static_cast<time_t>(random() >> (random() % 64));
+        bool completed = random() % 2;
+        randomTasks.emplace_back(1 + static_cast<int>(random() % 1'000'000), std::string(1 + random() % 300, 'r'),
+                                 completed, created, completed ? static_cast<time_t>(random()) : 0);
+    }
+    expectRoundTrip(randomTasks);
+}
+
+TEST_F(BinarySnapshotTest, RejectsTruncatedFiles) {
+    std::vector<Task> tasks;
+    for (int i = 1; i <= 50; i++) {
+        tasks.emplace_back(i, i % 7 == 0 ? std::string(150, 'l') : "task", i % 3 == 0, 1'700'000'000 + i * 97,
+                           i % 3 == 0 ? 1'800'000'000 : 0);
+    }
+    std::string contents = write(tasks);
+    for (std::size_t length = 0; length < contents.size(); length++) {
+        std::vector<Task> loaded;
+        std::string error;
+        EXPECT_FALSE(BinarySnapshot::read(std::string_view(contents).substr(0, length), loaded, error)) << length;
+        EXPECT_FALSE(error.empty());
+    }
+}
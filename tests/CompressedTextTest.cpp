@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "CompressedText.h"
+#include "FileManager.h"
+
+// Compressed task files need zstd at build time; without it there is nothing to round-trip.
+#ifdef TODO_ZSTD
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+class CompressedTextTest : public ::testing::Test {
+protected:
+    std::string directory = ::testing::TempDir() + "todo_compressed_text_test";
+    std::string path = directory + "/tasks.txt.zst";
+
+    void SetUp() override {
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+    }
+    void TearDown() override { std::filesystem::remove_all(directory); }
+};
+
+} // namespace
+
+// Several chunkSize frames, decompressed on one thread and on several, must load back the saved tasks
+TEST_F(CompressedTextTest, RoundTripsAcrossFrames) {
+    std::vector<Task> tasks;
+    std::size_t textSize = 0;
+    for (int id = 1; textSize < 3 * CompressedText::chunkSize + 1000; id++) {
+        tasks.emplace_back(id, "compressed task " + std::to_string(id) + std::string(id % 50, 'z'), id % 4 == 0,
+                           1'700'000'000 + id, id % 4 == 0 ? 1'800'000'000 + id : 0);
+        std::string line;
+        tasks.back().appendTo(line);
+        textSize += line.size();
+    }
+
+    FileManager writer(path);
+    writer.setFsyncPolicy(FsyncPolicy::Never);
+    ASSERT_EQ(writer.getSaveFormat(), FileFormat::Compressed);
+    ASSERT_TRUE(writer.saveTasks(tasks));
+    std::string contents = readFile(path);
+    ASSERT_TRUE(CompressedText::isCompressed(contents));
+
+    std::string single;
+    std::string parallel;
+    std::string error;
+    ASSERT_TRUE(CompressedText::decompress(contents, single, 1, error)) << error;
+    ASSERT_TRUE(CompressedText::decompress(contents, parallel, 4, error)) << error;
+    EXPECT_EQ(single, parallel);
+    EXPECT_GT(single.size(), 3 * CompressedText::chunkSize);
+
+    std::vector<Task> loaded = FileManager(path).loadTasks();
+    ASSERT_EQ(loaded.size(), tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+        std::string expected;
+        std::string actual;
+        tasks[i].appendTo(expected);
+        loaded[i].appendTo(actual);
+        ASSERT_EQ(actual, expected) << "task " << i;
+    }
+}
+
+// A frame header claiming far more text than its blocks could expand to is refused before allocating it
+TEST_F(CompressedTextTest, RejectsImpossibleDeclaredSize) {
+    std::string frame(reinterpret_cast<const char*>(CompressedText::magic), 4);
+    frame += '\xe0';                                    // Single segment, 8-byte content size
+    for (int i = 0; i < 8; i++) {
+        frame += static_cast<char>(i == 5 ? 1 : 0);     // 2^40 bytes
+    }
+    frame += std::string("\x01\x00\x00", 3);            // One empty raw block, the last
+
+    std::string text;
+    std::string error;
+    EXPECT_FALSE(CompressedText::decompress(frame, text, 1, error));
+    EXPECT_NE(error.find("declares more text"), std::string::npos) << error;
+    EXPECT_TRUE(text.empty());
+}
+
+#endif // TODO_ZSTD
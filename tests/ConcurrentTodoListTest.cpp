@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ConcurrentTodoList.h"
+
+// ConcurrentTodoList against a std::map of the same tasks for single-threaded changes, and against its own
+// promises (no task is ever lost or overwritten by an add) while adds race with clears.
+
+namespace {
+
+struct ReferenceTask {
+    std::string description;
+    bool completed;
+};
+
+std::map<int, ReferenceTask> contents(const ConcurrentTodoList& list) {
+    std::map<int, ReferenceTask> result;
+    ConcurrentTodoList::Snapshot snapshot = list.snapshot();
+    int previousId = 0;
+    snapshot.forEach([&](const Task& task) {
+        EXPECT_GT(task.getId(), previousId) << "tasks out of ID order";
+        previousId = task.getId();
+        result[task.getId()] = {task.getDescription().c_str(), task.isCompleted()};
+    });
+    return result;
+}
+
+void expectSame(const ConcurrentTodoList& list, const std::map<int, ReferenceTask>& reference) {
+    std::map<int, ReferenceTask> actual = contents(list);
+    ASSERT_EQ(actual.size(), reference.size());
+    std::size_t completed = 0;
+    for (const auto& [id, task] : reference) {
+        auto it = actual.find(id);
+        ASSERT_NE(it, actual.end()) << "missing task " << id;
+        EXPECT_EQ(it->second.description, task.description);
+        EXPECT_EQ(it->second.completed, task.completed);
+        if (task.completed) completed++;
+    }
+    ConcurrentTodoList::Snapshot snapshot = list.snapshot();
+    EXPECT_EQ(snapshot.size(), reference.size());
+    EXPECT_EQ(snapshot.completedCount(), completed);
+    EXPECT_EQ(snapshot.tasks(TaskView::Filter::Pending).size(), reference.size() - completed);
+}
+
+} // namespace
+
+TEST(ConcurrentTodoListTest, MatchesMapReference) {
+    std::mt19937 random(7);
+    ConcurrentTodoList list;
+    std::map<int, ReferenceTask> reference;
+    int nextId = 1;
+
+    for (int round = 0; round < 20000; round++) {
+        int choice = random() % 20;
+        if (choice < 10 || reference.empty()) {
+            std::string description = "task " + std::to_string(round);
+            ASSERT_EQ(list.addTask(description), nextId);
+            reference[nextId++] = {description, false};
+        } else {
+            // Sometimes an ID that doesn't exist, which must be refused
+            auto it = std::next(reference.begin(), random() % reference.size());
+            int id = random() % 8 == 0 ? nextId + 5 : it->first;
+            bool exists = reference.count(id) > 0;
+            if (choice < 14) {
+                EXPECT_EQ(list.markTaskAsCompleted(id), exists);
+                if (exists) reference[id].completed = true;
+            } else if (choice < 18) {
+                EXPECT_EQ(list.removeTask(id), exists);
+                reference.erase(id);
+            } else if (choice < 19) {
+                list.upsertTask(Task(id, "upserted", true, 1000, 2000));
+                reference[id] = {"upserted", true};
+                nextId = std::max(nextId, id + 1);
+            } else {
+                std::optional<Task> task = list.getTaskById(id);
+                ASSERT_EQ(task.has_value(), exists);
+                if (exists) {
+                    EXPECT_EQ(task->getDescriptionView(), reference[id].description);
+                }
+            }
+        }
+        if (round % 1000 == 0) expectSame(list, reference);
+    }
+    expectSame(list, reference);
+
+    // setTasks keeps the first of duplicate IDs and skips invalid ones; the counter follows the largest ID
+    std::vector<Task> tasks = {Task(3, "three"), Task(700, "seven hundred"), Task(3, "duplicate")};
+    list.setTasks(tasks);
+    reference = {{3, {"three", false}}, {700, {"seven hundred", false}}};
+    expectSame(list, reference);
+    EXPECT_EQ(list.addTask("next"), 701);
+
+    list.clearAllTasks();
+    expectSame(list, {});
+    EXPECT_EQ(list.addTask("first again"), 1);
+}
+
+// Adds that race with clearAllTasks may land before or after it, but never on top of another task:
+// whatever survives the race must still be there after another burst of adds
+TEST(ConcurrentTodoListTest, AddsRacingClearsNeverOverwrite) {
+    constexpr int adders = 4;
+    for (int round = 0; round < 20; round++) {
+        ConcurrentTodoList list;
+        std::atomic<int> running{adders};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < adders; t++) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 3000; i++) {
+                    list.addTask("race " + std::to_string(t) + " " + std::to_string(i));
+                }
+                running--;
+            });
+        }
+        std::thread clearer([&] {
+            while (running > 0) {
+                list.clearAllTasks();
+                std::this_thread::yield();
+            }
+        });
+        clearer.join();
+        for (auto& thread : threads) thread.join();
+        threads.clear();
+
+        // Quiet now: this is the reference, and every add from here on must come on top of it
+        std::map<int, ReferenceTask> reference = contents(list);
+        std::vector<std::vector<std::pair<int, std::string>>> added(adders);
+        for (int t = 0; t < adders; t++) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 500; i++) {
+                    std::string description = "after " + std::to_string(t) + " " + std::to_string(i);
+                    added[t].emplace_back(list.addTask(description), description);
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        for (const auto& tasks : added) {
+            for (const auto& [id, description] : tasks) {
+                ASSERT_TRUE(reference.emplace(id, ReferenceTask{description, false}).second)
+                    << "add returned the ID of a live task: " << id;
+            }
+        }
+        expectSame(list, reference);
+    }
+}
+
+// Readers walk snapshots while writers keep replacing, completing and removing tasks, so chunks and tasks
+// are retired and freed under them all the time; every task a reader reaches must still be intact
+TEST(ConcurrentTodoListTest, ReadersSeeIntactTasksWhileWritersChurn) {
+    constexpr int writers = 2;
+    constexpr int readers = 3;
+    ConcurrentTodoList list;
+    std::atomic<int> running{writers};
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; w++) {
+        threads.emplace_back([&, w] {
+            std::mt19937 random(w);
+            for (int i = 0; i < 20000; i++) {
+                int id = 1 + w + writers * static_cast<int>(random() % 2000); // Each writer owns its IDs
+                switch (random() % 3) {
+                    case 0: list.upsertTask(Task(id, "task " + std::to_string(id))); break;
+                    case 1: list.markTaskAsCompleted(id); break;
+                    default: list.removeTask(id); break;
+                }
+            }
+            running--;
+        });
+    }
+    std::atomic<long> checked{0};
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&] {
+            while (running > 0) {
+                ConcurrentTodoList::Snapshot snapshot = list.snapshot();
+                snapshot.forEach([&](const Task& task) {
+                    ASSERT_EQ(task.getDescriptionView(), "task " + std::to_string(task.getId()));
+                    checked++;
+                });
+                if (const Task* task = snapshot.find(1)) {
+                    ASSERT_EQ(task->getDescriptionView(), "task 1");
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_GT(checked.load(), 0);
+}
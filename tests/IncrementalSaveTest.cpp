@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include "FileManager.h"
+#include "TodoList.h"
+
+// Incremental saves of a TodoList against a full rewrite of the same list: after every round of changes
+// (appends, completions early in the list, removals with and without compaction, upserts, clears) the
+// tail-rewritten file must be byte for byte what a fresh atomic save writes.
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+ino_t inodeOf(const std::string& path) {
+    struct stat info {};
+    stat(path.c_str(), &info);
+    return info.st_ino;
+}
+
+class IncrementalSaveTest : public ::testing::Test {
+protected:
+    std::string directory = ::testing::TempDir() + "todo_incremental_save_test";
+    std::string incrementalPath = directory + "/incremental.txt";
+    std::string fullPath = directory + "/full.txt";
+
+    void SetUp() override {
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+    }
+    void TearDown() override { std::filesystem::remove_all(directory); }
+
+    // Saves the list both ways and compares the files
+    void expectSameAsFullSave(FileManager& incremental, TodoList& list) {
+        ASSERT_TRUE(incremental.saveTasks(list));
+        FileManager full(fullPath);
+        full.setFsyncPolicy(FsyncPolicy::Never);
+        ASSERT_TRUE(full.saveTasks(list.viewAllTasks()));
+        ASSERT_EQ(readFile(incrementalPath), readFile(fullPath));
+    }
+};
+
+} // namespace
+
+TEST_F(IncrementalSaveTest, TailRewritesMatchFullSaves) {
+    std::mt19937 random(99);
+    TodoList list;
+    FileManager incremental(incrementalPath);
+    incremental.setFsyncPolicy(FsyncPolicy::Never);
+    incremental.setIncrementalSaves(true);
+
+    for (int round = 0; round < 300; round++) {
+        int changes = 1 + random() % 20;
+        for (int i = 0; i < changes; i++) {
+            int maxId = list.getTaskCount() > 0 ? list.getAllTasks().back().getId() : 1;
+            int id = 1 + static_cast<int>(random() % maxId);
+            switch (random() % 10) {
+                case 0: case 1: case 2: case 3:
+                    list.addTask("task " + std::to_string(round) + "." + std::to_string(i) +
+                                 std::string(random() % 30, 'x'));
+                    break;
+                case 4: case 5: list.markTaskAsCompleted(id); break;
+                case 6: case 7: list.removeTask(id); break;
+                case 8: list.upsertTask(Task(id, "rewritten " + std::to_string(round))); break;
+                default:
+                    if (random() % 20 == 0) list.clearAllTasks();
+                    break;
+            }
+        }
+        expectSameAsFullSave(incremental, list);
+    }
+
+    // Someone else replacing the file invalidates the recorded layout: the next save writes it all again
+    FileManager other(incrementalPath);
+    ASSERT_TRUE(other.saveTasks(std::vector<Task>{Task(1, "not from this list")}));
+    list.addTask("one more");
+    expectSameAsFullSave(incremental, list);
+}
+
+TEST_F(IncrementalSaveTest, OnlyAppendsInPlaceWhenTurnedOn) {
+    TodoList list;
+    for (int i = 0; i < 1000; i++) list.addTask("task " + std::to_string(i));
+
+    // Off by default: every save goes through a temporary file and a rename
+    FileManager atomic(incrementalPath);
+    atomic.setFsyncPolicy(FsyncPolicy::Never);
+    ASSERT_TRUE(atomic.saveTasks(list));
+    ino_t first = inodeOf(incrementalPath);
+    list.addTask("appended");
+    ASSERT_TRUE(atomic.saveTasks(list));
+    EXPECT_NE(inodeOf(incrementalPath), first);
+
+    // Turned on: appends land in the same file
+    FileManager incremental(incrementalPath);
+    incremental.setFsyncPolicy(FsyncPolicy::Never);
+    incremental.setIncrementalSaves(true);
+    ASSERT_TRUE(incremental.saveTasks(list));
+    ino_t written = inodeOf(incrementalPath);
+    list.addTask("appended in place");
+    expectSameAsFullSave(incremental, list);
+    EXPECT_EQ(inodeOf(incrementalPath), written);
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "BinarySnapshot.h"
+#include "Journal.h"
+#include "TodoList.h"
+
+// Journal recovery against the list that was journaled: whatever mix of changes and compactions came first,
+// loading the snapshot and replaying the logs into a fresh list must give back exactly the same tasks.
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// Every task as its saved line, in list order
+std::vector<std::string> lines(const TodoList& list) {
+    std::vector<std::string> result;
+    for (const Task& task : list.viewAllTasks()) {
+        std::string line;
+        task.appendTo(line);
+        result.push_back(std::move(line));
+    }
+    return result;
+}
+
+class JournalTest : public ::testing::Test {
+protected:
+    std::string directory = ::testing::TempDir() + "todo_journal_test";
+    std::string snapshotPath = directory + "/tasks.txt";
+    std::mt19937 random{31};
+
+    void SetUp() override {
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+    }
+    void TearDown() override { std::filesystem::remove_all(directory); }
+
+    void mutate(TodoList& list, int changes) {
+        for (int i = 0; i < changes; i++) {
+            int count = list.getTaskCount();
+            int id = count > 0 ? list.getAllTasks()[random() % count].getId() : 1;
+            switch (random() % 8) {
+                case 0: case 1: case 2: list.addTask("journaled task " + std::to_string(random() % 1000)); break;
+                case 3: case 4: list.markTaskAsCompleted(id); break;
+                case 5: list.removeTask(id); break;
+                case 6: list.upsertTask(Task(id + 3, "upserted", true, 1'700'000'000, 1'700'000'100)); break;
+                default: if (random() % 10 == 0) list.clearAllTasks(); break;
+            }
+        }
+    }
+
+    void expectRecovers(const TodoList& list) {
+        Journal reader(snapshotPath);
+        TodoList recovered;
+        std::size_t replayed = 0;
+        ASSERT_TRUE(reader.recover(recovered, replayed));
+        ASSERT_EQ(lines(recovered), lines(list));
+    }
+};
+
+} // namespace
+
+TEST_F(JournalTest, ReplayConvergesThroughCompactions) {
+    TodoList list;
+    Journal journal(snapshotPath);
+    journal.setCompactionThreshold(0);
+    journal.attach(list);
+
+    for (int round = 0; round < 60; round++) {
+        mutate(list, 1 + random() % 40);
+        if (random() % 3 == 0) {
+            // Sometimes keep changing the list while the snapshot is still being written
+            ASSERT_TRUE(journal.compact());
+            mutate(list, random() % 10);
+            ASSERT_TRUE(journal.waitForCompaction());
+        }
+        expectRecovers(list);
+    }
+}
+
+// A crash after the snapshot was written but before the folded-in log was deleted replays records the
+// snapshot already contains; they must converge to the same list, not duplicate or resurrect anything
+TEST_F(JournalTest, ReplayOverSnapshotThatHasTheRecordsConverges) {
+    TodoList list;
+    Journal journal(snapshotPath);
+    journal.setCompactionThreshold(0);
+    journal.attach(list);
+
+    mutate(list, 300);
+    std::string folded = readFile(snapshotPath + ".journal");
+    ASSERT_TRUE(journal.compact());
+    ASSERT_TRUE(journal.waitForCompaction());
+    mutate(list, 50);
+
+    std::ofstream(snapshotPath + ".journal.old", std::ios::binary) << folded;
+    expectRecovers(list);
+}
+
+TEST_F(JournalTest, CompactionWritesTheChosenFormat) {
+    TodoList list;
+    Journal journal(snapshotPath, FsyncPolicy::Never, FileFormat::Binary);
+    journal.attach(list);
+    mutate(list, 200);
+    ASSERT_TRUE(journal.compact());
+    ASSERT_TRUE(journal.waitForCompaction());
+
+    EXPECT_TRUE(BinarySnapshot::isBinarySnapshot(readFile(snapshotPath)));
+    mutate(list, 20);
+    expectRecovers(list);
+}
+
+// A snapshot that is there but can't be read must not be treated as empty: recovery fails, and nothing may
+// write a snapshot rebuilt from the logs alone over it
+TEST_F(JournalTest, UnreadableSnapshotIsNeverOverwritten) {
+    {
+        TodoList list;
+        Journal journal(snapshotPath, FsyncPolicy::Never, FileFormat::Binary);
+        journal.attach(list);
+        mutate(list, 300);
+        ASSERT_TRUE(journal.compact());
+        ASSERT_TRUE(journal.waitForCompaction());
+        mutate(list, 30);
+    }
+
+    // Flip a byte in the middle of the columns: the checksum no longer matches
+    std::string snapshot = readFile(snapshotPath);
+    ASSERT_TRUE(BinarySnapshot::isBinarySnapshot(snapshot));
+    snapshot[snapshot.size() / 2] ^= 0x5a;
+    std::ofstream(snapshotPath, std::ios::binary | std::ios::trunc) << snapshot;
+    std::string log = readFile(snapshotPath + ".journal");
+
+    TodoList list;
+    list.addTask("already here");
+    Journal journal(snapshotPath, FsyncPolicy::Never, FileFormat::Binary);
+    std::size_t replayed = 0;
+    EXPECT_FALSE(journal.recover(list, replayed));
+    EXPECT_EQ(replayed, 0u);
+    EXPECT_EQ(list.getTaskCount(), 1);
+
+    EXPECT_FALSE(journal.attach(list));
+    EXPECT_FALSE(journal.compact());
+    list.addTask("not journaled");
+    EXPECT_EQ(readFile(snapshotPath), snapshot);
+    EXPECT_EQ(readFile(snapshotPath + ".journal"), log);
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <string>
+#include <vector>
+#include "TaskSearchIndex.h"
+#include "TodoList.h"
+
+// TodoList::search against a linear scan that tokenizes every description from scratch, while tasks are
+// added, completed, removed (crossing the compaction threshold) and rewritten under an already built index.
+
+namespace {
+
+struct ReferenceTask {
+    int id;
+    std::string description;
+    bool completed;
+};
+
+// Lowercased runs of letters, digits and non-ASCII bytes, written independently of TaskSearchIndex::tokenize
+std::vector<std::string> words(const std::string& text) {
+    std::vector<std::string> result(1);
+    for (unsigned char c : text) {
+        if (std::isalnum(c) || c >= 0x80) {
+            result.back() += static_cast<char>(std::tolower(c));
+        } else if (!result.back().empty()) {
+            result.emplace_back();
+        }
+    }
+    if (result.back().empty()) {
+        result.pop_back();
+    }
+    return result;
+}
+
+bool matches(const ReferenceTask& task, const TaskQuery& query) {
+    if (query.matchesNothing) return false;
+    if (query.status == TaskView::Filter::Completed && !task.completed) return false;
+    if (query.status == TaskView::Filter::Pending && task.completed) return false;
+    if (task.description.find(query.substring) == std::string::npos) return false;
+    if (query.terms.empty() && query.prefixes.empty()) return true;
+
+    std::vector<std::string> found = words(task.description);
+    std::vector<bool> hits;
+    for (const std::string& term : query.terms) {
+        std::string lower = words(term).front();
+        hits.push_back(std::find(found.begin(), found.end(), lower) != found.end());
+    }
+    for (const std::string& start : query.prefixes) {
+        std::string lower = words(start).front();
+        hits.push_back(std::any_of(found.begin(), found.end(),
+                                   [&](const std::string& word) { return word.starts_with(lower); }));
+    }
+    return query.mode == TaskQuery::Mode::All ? std::all_of(hits.begin(), hits.end(), [](bool hit) { return hit; })
+                                              : std::any_of(hits.begin(), hits.end(), [](bool hit) { return hit; });
+}
+
+class SearchIndexTest : public ::testing::Test {
+protected:
+    const std::vector<std::string> vocabulary = {"Buy", "milk", "milkshake", "call", "Caller", "mom", "fix",
+                                                 "fixture", "bike", "report", "q3", "caf\xc3\xa9", "read", "ready"};
+    std::mt19937 random{12345};
+    TodoList list;
+    std::vector<ReferenceTask> reference;  // In list order
+    int nextId = 1;                        // IDs are never reused, even after the newest task is removed
+
+    std::string word() { return vocabulary[random() % vocabulary.size()]; }
+
+    std::string description() {
+        static const char* separators[] = {" ", ", ", "-", " (", "! "};
+        std::string text = word();
+        for (int words = random() % 4; words > 0; words--) {
+            text += separators[random() % 5];
+            text += word();
+        }
+        return text;
+    }
+
+    TaskQuery query() {
+        TaskQuery query;
+        for (int count = random() % 3; count > 0; count--) query.terms.push_back(word());
+        for (int count = random() % 2; count > 0; count--) query.prefixes.push_back(word().substr(0, 1 + random() % 3));
+        query.mode = random() % 2 ? TaskQuery::Mode::All : TaskQuery::Mode::Any;
+        query.status = static_cast<TaskView::Filter>(random() % 3);
+        if (random() % 5 == 0) query.substring = word().substr(0, 2);
+        return query;
+    }
+
+    void mutate() {
+        int choice = random() % 10;
+        if (choice < 4 || reference.empty()) {
+            std::string text = description();
+            list.addTask(text);
+            reference.push_back({nextId++, text, false});
+            return;
+        }
+        ReferenceTask& task = reference[random() % reference.size()];
+        if (choice < 6) {
+            list.markTaskAsCompleted(task.id);
+            task.completed = true;
+        } else if (choice < 8) {
+            // Rewrites the description (and resets the status) in place
+            task.description = description();
+            task.completed = false;
+            list.upsertTask(Task(task.id, task.description));
+        } else {
+            list.removeTask(task.id);
+            reference.erase(reference.begin() + (&task - reference.data()));
+        }
+    }
+
+    void expectSameResults(const TaskQuery& query) {
+        std::vector<int> expected, actual;
+        for (const ReferenceTask& task : reference) {
+            if (matches(task, query)) expected.push_back(task.id);
+        }
+        for (const Task& task : list.search(query)) {
+            actual.push_back(task.getId());
+        }
+        ASSERT_EQ(actual, expected);
+    }
+};
+
+} // namespace
+
+TEST_F(SearchIndexTest, MatchesLinearScanWhileTheListChanges) {
+    for (int round = 0; round < 3000; round++) {
+        mutate();
+        if (round % 7 == 0) {
+            // Frequent queries keep the index built, so later changes go through its incremental path
+            for (int i = 0; i < 5; i++) expectSameResults(query());
+        }
+    }
+    for (int i = 0; i < 500; i++) expectSameResults(query());
+}
+
+TEST_F(SearchIndexTest, ParsedQueriesMatchLinearScan) {
+    for (int i = 0; i < 400; i++) mutate();
+    for (const char* text : {"milk", "MILK call", "mil*", "milk OR bike", "status:pending fix*", "\"e, \"",
+                             "status:completed caf\xc3\xa9 OR q3", "rea* OR ready", "nothing", "milk-shake*",
+                             "(fix)-fixt*", "Call, cal*", "status:pending ---", "*", "\"milk\" !!"}) {
+        expectSameResults(TaskQuery::parse(text));
+    }
+}
+
+// Prefix tokens split at punctuation like descriptions do, and words that are only punctuation match nothing
+TEST(TaskQueryTest, ParsesWordsLikeTheIndexer) {
+    TaskQuery split = TaskQuery::parse("Foo-Bar*");
+    EXPECT_EQ(split.terms, std::vector<std::string>{"foo"});
+    EXPECT_EQ(split.prefixes, std::vector<std::string>{"bar"});
+    EXPECT_FALSE(split.matchesNothing);
+
+    EXPECT_TRUE(TaskQuery::parse("---").matchesNothing);
+    EXPECT_TRUE(TaskQuery::parse("status:pending !! *").matchesNothing);
+    EXPECT_FALSE(TaskQuery::parse("status:completed").matchesNothing);
+    EXPECT_FALSE(TaskQuery::parse("\"a b\"").matchesNothing);
+
+    TodoList list;
+    list.addTask("foo-bar baz");
+    EXPECT_EQ(list.search(TaskQuery::parse("foo-ba*")).size(), 1u);
+    EXPECT_EQ(list.search(TaskQuery::parse("-!-")).size(), 0u);
+}
+
+// Tens of thousands of distinct words under one prefix (merged through the bitmap) and a handful of scattered
+// ones (merged by sorting): both must match a scan, without the lookup growing with words x results
+TEST_F(SearchIndexTest, PrefixOverManyDistinctWords) {
+    for (int i = 0; i < 60'000; i++) {
+        std::string text = "a" + std::to_string(i % 20'000) + " " + word();
+        if (i % 5'000 == 17) text += " rare" + std::to_string(i);  // A prefix over few, scattered slots
+        list.addTask(text);
+        reference.push_back({nextId++, text, false});
+    }
+    for (const char* text : {"a*", "a1*", "a19999*", "A*  status:pending", "a* OR milk", "a12* bike", "rare*", "rare* a17"}) {
+        expectSameResults(TaskQuery::parse(text));
+    }
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+#include "TaskTimeIndex.h"
+
+// TaskTimeIndex against a std::multiset of the same pairs, through interleaved in-order inserts, out-of-order
+// inserts, erases (of run and buffered entries alike) and the folds they trigger.
+
+namespace {
+
+using Entry = TaskTimeIndex::Entry;
+
+class TaskTimeIndexTest : public ::testing::Test {
+protected:
+    std::mt19937 random{2024};
+    TaskTimeIndex index;
+    std::multiset<Entry> reference;
+    time_t now = 1'700'000'000;
+    std::size_t nextSlot = 0;
+
+    void insert(time_t time) {
+        std::size_t slot = nextSlot++;
+        index.insert(time, slot);
+        reference.insert({time, slot});
+    }
+
+    void eraseRandom() {
+        auto it = std::next(reference.begin(), random() % reference.size());
+        index.erase(it->time, it->slot);
+        reference.erase(it);
+    }
+
+    // A few steps of the usual traffic: mostly "now" inserts, some backdated ones and some erases
+    void mutate(int steps, int eraseWeight) {
+        for (int i = 0; i < steps; i++) {
+            int choice = random() % 10;
+            if (choice < eraseWeight && !reference.empty()) {
+                eraseRandom();
+            } else if (choice < 7) {
+                now += random() % 3;  // Repeats of the same second too
+                insert(now);
+            } else {
+                insert(now - static_cast<time_t>(random() % 100'000));
+            }
+        }
+    }
+
+    void expectSameAnswers() {
+        ASSERT_EQ(index.size(), reference.size());
+        for (int i = 0; i < 20; i++) {
+            time_t from = now - static_cast<time_t>(random() % 120'000);
+            time_t to = from + static_cast<time_t>(random() % 50'000);
+
+            std::size_t expectedCount = 0;
+            for (const Entry& entry : reference) {
+                if (entry.time >= from && entry.time < to) expectedCount++;
+            }
+            ASSERT_EQ(index.countBetween(from, to), expectedCount) << "from " << from << " to " << to;
+
+            // forEachBetween is inclusive and ordered by (time, slot); stop it partway now and then
+            std::size_t limit = random() % 4 == 0 ? random() % 10 : SIZE_MAX;
+            std::vector<std::size_t> expected, actual;
+            for (auto it = reference.lower_bound({from, 0}); it != reference.end() && it->time <= to; ++it) {
+                if (expected.size() == limit) break;
+                expected.push_back(it->slot);
+            }
+            index.forEachBetween(from, to, [&](std::size_t slot) {
+                if (actual.size() == limit) return false;
+                actual.push_back(slot);
+                return true;
+            });
+            ASSERT_EQ(actual, expected) << "from " << from << " to " << to;
+        }
+    }
+};
+
+} // namespace
+
+TEST_F(TaskTimeIndexTest, MatchesSortedReferenceThroughFolds) {
+    for (int round = 0; round < 400; round++) {
+        // Alternate growing and shrinking phases, so the buffers fold both ways
+        mutate(25, round % 40 < 30 ? 2 : 6);
+        expectSameAnswers();
+    }
+}
+
+TEST_F(TaskTimeIndexTest, MatchesSortedReferenceAfterAssignAndClear) {
+    mutate(500, 2);
+    std::vector<Entry> entries(reference.begin(), reference.end());
+    std::shuffle(entries.begin(), entries.end(), random);
+    index.assign(std::move(entries));
+    expectSameAnswers();
+    mutate(300, 4);
+    expectSameAnswers();
+
+    index.clear();
+    reference.clear();
+    expectSameAnswers();
+    mutate(200, 3);
+    expectSameAnswers();
+}
+
+TEST_F(TaskTimeIndexTest, EmptiesWhenEverythingIsErased) {
+    mutate(1000, 0);
+    while (!reference.empty()) {
+        eraseRandom();
+        if (reference.size() % 97 == 0) expectSameAnswers();
+    }
+    expectSameAnswers();
+    EXPECT_EQ(index.countBetween(0, now + 1), 0u);
+}